@@ -1,2 +1,5 @@
 #include "ecs/BaseSystem.hpp"
-#include "ecs/EntitiesManager.hpp"
\ No newline at end of file
+#include "ecs/CommandBuffer.hpp"
+#include "ecs/CommandQueue.hpp"
+#include "ecs/EntitiesManager.hpp"
+#include "ecs/SystemManager.hpp"
\ No newline at end of file
@@ -0,0 +1,93 @@
+#ifndef ARCHETYPE_HPP
+#define ARCHETYPE_HPP
+
+#include <string.h>
+#include <vector>
+
+#include "GroupMask.hpp"
+
+namespace rv
+{
+    struct Archetype;
+
+    /**
+     * @brief Cached transitions of an archetype when a given component type is added or removed.
+     */
+    struct ArchetypeEdge
+    {
+        int32_t type;
+        Archetype* add;
+        Archetype* remove;
+    };
+
+    /**
+     * @brief Unique set of component types, shared by every entity that has exactly those types.
+     */
+    struct Archetype
+    {
+        /**
+         * @brief Sequential id of the archetype, used to index per-archetype caches.
+         */
+        int32_t id;
+        /**
+         * @brief Mask of the component groups that store this archetype.
+         */
+        GroupMask mask;
+        /**
+         * @brief Component type ids of this archetype.
+         */
+        int32_t typesCount;
+        int32_t* types;
+        /**
+         * @brief Whether removals keep the order of the remaining entities, see \see{ComponentTraits::ordered}.
+         */
+        bool ordered;
+        /**
+         * @brief Transitions already taken from this archetype.
+         */
+        std::vector<ArchetypeEdge> edges;
+
+        inline Archetype(const int32_t id, const int32_t* types, const int32_t typesCount)
+            : id(id), mask(types, typesCount), typesCount(typesCount), types(new int32_t[typesCount]), ordered(false)
+        {
+            memcpy(this->types, types, typesCount * sizeof(int32_t));
+            for (int32_t i = 0; i < typesCount; i++)
+            {
+                ordered |= ComponentTypes::ordered(types[i]);
+            }
+        }
+
+        ~Archetype() { delete[] types; }
+
+        inline bool hasType(const int32_t type) const;
+
+        /**
+         * @brief Returns the transitions edge for the given type, creating an empty one if needed.
+         *
+         * @param type Component type id of the transition.
+         * @return ArchetypeEdge& Edge whose transitions may still be unresolved (nullptr).
+         */
+        inline ArchetypeEdge& getEdge(const int32_t type);
+    };
+
+    inline bool Archetype::hasType(const int32_t type) const
+    {
+        return mask.test(type);
+    }
+
+    inline ArchetypeEdge& Archetype::getEdge(const int32_t type)
+    {
+        for (ArchetypeEdge& edge : edges)
+        {
+            if (edge.type == type)
+            {
+                return edge;
+            }
+        }
+        edges.push_back({type, nullptr, nullptr});
+        return edges.back();
+    }
+
+} // namespace rv
+
+#endif
\ No newline at end of file
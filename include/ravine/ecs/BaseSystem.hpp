@@ -1,21 +1,114 @@
 #ifndef BASESYSTEM_HPP
 #define BASESYSTEM_HPP
 
+#include <algorithm>
+#include <vector>
+
 #include "EntitiesManager.hpp"
 #include "ISystem.h"
+#include "QueryFilters.hpp"
 #include "TemplateIndexPack.h"
+#include "ThreadPool.hpp"
+
+// Size (in bytes) of the components each task of a parallel system runs through, around a L2 cache
+#ifndef RV_PARALLEL_BATCH_BYTES
+#define RV_PARALLEL_BATCH_BYTES (256 * 1024)
+#endif
 
 using std::get;
 
 namespace rv
 {
 
-    template <class... TComps>
-    class BaseSystem : public ISystem
+    template <class TKernel, class TComponents, class TFilters>
+    class QuerySystem;
+
+    /**
+     * @brief System running through the components of the entities matching a query, \see{BaseSystem}.
+     *
+     * @tparam TKernel Most derived class, whose beforeUpdate, updateChunk and afterUpdate functions are called
+     * without any virtual dispatch (\see{BaseSystem} forwards them to virtual functions, \see{StaticSystem} doesn't).
+     * @tparam TComps Fetched component types, handed to the kernel as one chunk pointer each.
+     * @tparam TFilters Filters resolved once per archetype, when the iterators are rebuilt.
+     */
+    template <class TKernel, class... TComps, class... TFilters>
+    class QuerySystem<TKernel, TypeList<TComps...>, TypeList<TFilters...>> : public ISystem
     {
       private:
-        tuple<CompGroupIt<TComps>...> compIterators;
-        tuple<TComps*...> chunkData;
+        using Iterators = tuple<CompGroupIt<ComponentType<TComps>>...>;
+        using ChunkData = tuple<ComponentPointer<TComps>...>;
+
+        /**
+         * @brief Index of the first non-optional type, whose groups give the size of every matched archetype.
+         */
+        inline static constexpr int32_t firstRequired()
+        {
+            constexpr bool optional[] = {ComponentAccess<TComps>::optional...};
+            for (int32_t i = 0; i < (int32_t)sizeof...(TComps); i++)
+            {
+                if (!optional[i])
+                {
+                    return i;
+                }
+            }
+            return -1;
+        }
+
+        static constexpr int32_t requiredId = firstRequired();
+        static_assert(requiredId >= 0, "Queries need at least one non-optional component type");
+
+        /**
+         * @brief Whether the query only needs the archetypes to have every type, the storages queries then match.
+         */
+        static constexpr bool plainQuery =
+            sizeof...(TFilters) == 0 && (true && ... && !ComponentAccess<TComps>::optional);
+
+        /**
+         * @brief Whether chunks are skipped unless changed, they are then split at change blocks boundaries.
+         */
+        static constexpr bool tracksChanges = (false || ... || ComponentAccess<TComps>::changed);
+
+        Iterators compIterators;
+        ChunkData chunkData;
+        tuple<ComponentStorage<ComponentType<TComps>>*...> storages;
+        /**
+         * @brief Storage versions the iterators were built with.
+         */
+        uint32_t versions[sizeof...(TComps)];
+        /**
+         * @brief Change version of the current run, and of the previous one.
+         */
+        uint32_t runVersion = 0;
+        uint32_t lastRunVersion = 0;
+
+        /**
+         * @brief Slice of a chunk ran by a single task in parallel mode.
+         */
+        struct ChunkBatch
+        {
+            ChunkData data;
+            /**
+             * @brief Global index of the first entity of the batch.
+             */
+            int32_t offset;
+            int32_t size;
+        };
+
+        /**
+         * @brief Amount of entities of each batch, a multiple of RV_CHUNK_LANES so batches keep chunks aligned.
+         */
+        static constexpr int32_t batchEntities =
+            std::max(RV_CHUNK_LANES, (int32_t)(RV_PARALLEL_BATCH_BYTES / (0 + ... + sizeof(ComponentType<TComps>))) &
+                                         ~(RV_CHUNK_LANES - 1));
+
+        ThreadPool* pool = nullptr;
+        std::vector<ChunkBatch> batches;
+        /**
+         * @brief Masks of the matched archetypes, in iteration order (only filled by filtered queries).
+         */
+        std::vector<GroupMask> masks;
+
+        inline TKernel& kernel() { return static_cast<TKernel&>(*this); }
 
         template <int... T>
         struct FetchPack;
@@ -23,8 +116,8 @@ namespace rv
         template <>
         struct FetchPack<>
         {
-            static inline intptr_t fetchChunk(tuple<TComps*...>& chunkData, tuple<CompGroupIt<TComps>...>& compIt,
-                                              int32_t groupId, int32_t fetchId)
+            static inline intptr_t fetchChunk(ChunkData& /*chunkData*/, Iterators& /*compIt*/, int32_t /*groupId*/,
+                                              int32_t /*fetchId*/)
             {
                 return INT32_MAX;
             }
@@ -33,8 +126,8 @@ namespace rv
         template <int I, int... S>
         struct FetchPack<I, S...>
         {
-            static inline int32_t fetchChunk(tuple<TComps*...>& chunkData, tuple<CompGroupIt<TComps>...>& compIt,
-                                             int32_t groupId, int32_t fetchId)
+            static inline int32_t fetchChunk(ChunkData& chunkData, Iterators& compIt, int32_t groupId,
+                                             int32_t fetchId)
             {
                 int32_t lGroupSize = 0;
                 get<I>(chunkData) = get<I>(compIt).compIt[groupId].getChunk(fetchId, lGroupSize);
@@ -44,7 +137,98 @@ namespace rv
         };
 
         /**
-         * @brief Calls the virtual \see{update} function by unfolding their arguments with a compile-time sequence
+         * @brief Checks the storages versions, updating the cached ones.
+         *
+         * @return bool Whether any storage changed since the iterators were built.
+         */
+        template <int... S>
+        inline bool updateVersions(seq<S...>)
+        {
+            using expander = int[];
+            bool outdated = false;
+            expander{0, ((void)(outdated |= versions[S] != get<S>(storages)->version),
+                         (void)(versions[S] = get<S>(storages)->version), 0)...};
+            return outdated;
+        }
+
+        /**
+         * @brief Rebuilds the iterators, matching the filters against each archetype mask.
+         */
+        template <int... S>
+        inline void buildIterators(seq<S...>)
+        {
+            if constexpr (plainQuery)
+            {
+                EntitiesManager::getComponentIterators<ComponentType<TComps>...>(compIterators);
+            }
+            else
+            {
+                using expander = int[];
+                masks.clear();
+                for (const auto& groupIt : get<requiredId>(storages)->getQuery(requiredMask())->second)
+                {
+                    if ((true && ... && TFilters::matches(groupIt->first)))
+                    {
+                        masks.push_back(groupIt->first);
+                    }
+                }
+                expander{0, ((void)get<S>(storages)->getComponentIterator(masks.data(), (int32_t)masks.size(),
+                                                                          get<S>(compIterators)),
+                             0)...};
+            }
+        }
+
+        /**
+         * @brief Mask of the non-optional types, every matched archetype has them all.
+         */
+        inline static const GroupMask& requiredMask()
+        {
+            static const GroupMask mask = []() {
+                using expander = int[];
+                GroupMask required;
+                expander{0, ((void)(ComponentAccess<TComps>::optional
+                                        ? void()
+                                        : required.set(ComponentStorage<ComponentType<TComps>>::getInstance()->typeId)),
+                             0)...};
+                return required;
+            }();
+            return mask;
+        }
+
+        /**
+         * @brief Fetches the chunk starting at the given id of a group, then tracks its changes.
+         * Mutable chunks are stamped with the run version, unless skipped.
+         *
+         * @param changed Whether the chunk should be handed to the kernel, false if unchanged.
+         * @return int32_t Size of the chunk.
+         */
+        template <int... S>
+        inline int32_t nextChunk(const int32_t groupId, const int32_t fetchId, bool& changed, seq<S...>)
+        {
+            using expander = int[];
+            int32_t chunkSize = FetchPack<S...>::fetchChunk(chunkData, compIterators, groupId, fetchId);
+            changed = true;
+            if constexpr (tracksChanges)
+            {
+                const int32_t blockRun = ChangeTracking::blockRun(fetchId);
+                chunkSize = (chunkSize < blockRun) ? chunkSize : blockRun;
+                changed = (false || ... ||
+                           (ComponentAccess<TComps>::changed &&
+                            get<S>(compIterators).compIt[groupId].changedSince(fetchId, chunkSize, lastRunVersion)));
+            }
+            if (changed)
+            {
+                expander{0, ((void)(ComponentAccess<TComps>::readOnly
+                                        ? void()
+                                        : get<S>(compIterators).compIt[groupId].markChanged(fetchId, chunkSize,
+                                                                                            runVersion)),
+                             0)...};
+            }
+            return chunkSize;
+        }
+
+        /**
+         * @brief Calls the kernel updateChunk function by unfolding their arguments with a compile-time sequence
          * list.
          *
          * @tparam S Type list id sequence
@@ -54,32 +238,142 @@ namespace rv
         template <int... S>
         inline void updateUnfold(double deltaTime, seq<S...>)
         {
-            beforeUpdate(deltaTime);
+            kernel().beforeUpdate(deltaTime);
+
+            const int32_t groupCount = get<requiredId>(compIterators).count;
+            int32_t offset = 0;
+            int32_t batchSize = 0;
+            for (int32_t i = 0; i < groupCount; i++)
+            {
+                batchSize += get<requiredId>(compIterators).compIt[i].getSize();
+            }
+            for (int32_t i = 0; i < groupCount; i++)
+            {
+                int32_t fetchIt = 0;
+                int32_t groupSize = get<requiredId>(compIterators).compIt[i].getSize();
+                while (fetchIt < groupSize)
+                {
+                    bool changed;
+                    int32_t chunkSize = nextChunk(i, fetchIt, changed, seq<S...>());
+                    if (changed)
+                    {
+                        kernel().updateChunk(deltaTime, offset, batchSize, chunkSize, get<S>(chunkData)...);
+                    }
+                    fetchIt += chunkSize;
+                    offset += chunkSize;
+                }
+            }
+
+            kernel().afterUpdate(deltaTime);
+        }
+
+        /**
+         * @brief Offsets a chunk pointer, missing optional chunks stay nullptr.
+         */
+        template <class T>
+        inline static T* advance(T* chunk, int32_t count)
+        {
+            return chunk != nullptr ? chunk + count : nullptr;
+        }
+
+        /**
+         * @brief Same as \see{updateUnfold}, but splits the chunks in cache-sized batches run by the pool workers.
+         */
+        template <int... S>
+        inline void updateParallel(double deltaTime, seq<S...>)
+        {
+            kernel().beforeUpdate(deltaTime);
 
-            const uint8_t groupCount = get<0>(compIterators).count;
+            const int32_t groupCount = get<requiredId>(compIterators).count;
             int32_t offset = 0;
             int32_t batchSize = 0;
-            for (uint8_t i = 0; i < groupCount; i++)
+            for (int32_t i = 0; i < groupCount; i++)
             {
-                batchSize += get<0>(compIterators).compIt[i].getSize();
+                batchSize += get<requiredId>(compIterators).compIt[i].getSize();
             }
-            for (uint8_t i = 0; i < groupCount; i++)
+            batches.clear();
+            for (int32_t i = 0; i < groupCount; i++)
             {
                 int32_t fetchIt = 0;
-                int32_t groupSize = get<0>(compIterators).compIt[i].getSize();
+                int32_t groupSize = get<requiredId>(compIterators).compIt[i].getSize();
                 while (fetchIt < groupSize)
                 {
-                    int32_t chunkSize = FetchPack<S...>::fetchChunk(chunkData, compIterators, i, fetchIt);
-                    update(deltaTime, offset, batchSize, chunkSize, get<S>(chunkData)...);
+                    bool changed;
+                    int32_t chunkSize = nextChunk(i, fetchIt, changed, seq<S...>());
+                    for (int32_t first = 0; changed && first < chunkSize; first += batchEntities)
+                    {
+                        const int32_t size = (chunkSize - first < batchEntities) ? chunkSize - first : batchEntities;
+                        batches.push_back({ChunkData(advance(get<S>(chunkData), first)...), offset + first, size});
+                    }
                     fetchIt += chunkSize;
                     offset += chunkSize;
                 }
             }
 
-            afterUpdate(deltaTime);
+            pool->parallelFor((int32_t)batches.size(), [this, deltaTime, batchSize](const int32_t batchId) {
+                const ChunkBatch& batch = batches[batchId];
+                kernel().updateChunk(deltaTime, batch.offset, batchSize, batch.size, get<S>(batch.data)...);
+            });
+
+            kernel().afterUpdate(deltaTime);
         }
 
       public:
+        /**
+         * @brief Whether each component type (in order) is only read, known at compile time.
+         */
+        static constexpr bool readOnly[] = {ComponentAccess<TComps>::readOnly...};
+
+        /**
+         * @brief Whether the system only reads the given component type (or doesn't access it at all).
+         */
+        template <class TComponent>
+        inline static constexpr bool reads()
+        {
+            return (true && ... && (!std::is_same<ComponentType<TComps>, TComponent>::value ||
+                                    ComponentAccess<TComps>::readOnly));
+        }
+
+        /**
+         * @brief Masks of the component types the system reads and writes, for schedulers.
+         */
+        inline static void getAccessMasks(GroupMask& readMask, GroupMask& writeMask)
+        {
+            using expander = int[];
+            expander{0, ((void)(ComponentAccess<TComps>::readOnly
+                                    ? readMask.set(ComponentTypes::id<ComponentType<TComps>>())
+                                    : writeMask.set(ComponentTypes::id<ComponentType<TComps>>())),
+                         0)...};
+        }
+
+        QuerySystem() : storages(ComponentStorage<ComponentType<TComps>>::getInstance()...)
+        {
+            for (uint32_t& version : versions)
+            {
+                version = UINT32_MAX;
+            }
+        }
+
+        /**
+         * @brief Rebuilds the iterators if the storages changed since the last update.
+         */
+        void prepare() final
+        {
+            if (updateVersions(typename gens<sizeof...(TComps)>::type()))
+            {
+                buildIterators(typename gens<sizeof...(TComps)>::type());
+            }
+        }
+
+        /**
+         * @brief Opts in (or out, with nullptr) of running the chunks of this system in parallel.
+         * Chunks are split in batches of about RV_PARALLEL_BATCH_BYTES, the per-chunk kernel calls then run
+         * concurrently on the pool and must only touch the entities of their own batch.
+         *
+         * @param pool Pool running the batches, \see{beforeUpdate} and \see{afterUpdate} still run on the caller.
+         */
+        inline void setParallel(ThreadPool* pool) { this->pool = pool; }
+
         /**
          * @brief Update base function, called by the ECS framework \see{SystemManager}.
          *
@@ -87,18 +381,38 @@ namespace rv
          */
         void update(double deltaTime) final
         {
-            // Get Updated List of Iterators
-            compIterators = EntitiesManager::getComponentIterators<TComps...>();
-            updateUnfold(deltaTime, typename gens<sizeof...(TComps)>::type());
+            prepare();
+            runVersion = ChangeTracking::nextRun();
+            if (pool != nullptr)
+            {
+                updateParallel(deltaTime, typename gens<sizeof...(TComps)>::type());
+            }
+            else
+            {
+                updateUnfold(deltaTime, typename gens<sizeof...(TComps)>::type());
+            }
+            lastRunVersion = runVersion;
         }
+    };
 
+    template <class TComponents, class TFilters>
+    class VirtualSystem;
+
+    /**
+     * @brief Query system whose kernel forwards every chunk to virtual functions, the base of \see{BaseSystem}.
+     */
+    template <class... TComps, class TFilters>
+    class VirtualSystem<TypeList<TComps...>, TFilters>
+        : public QuerySystem<VirtualSystem<TypeList<TComps...>, TFilters>, TypeList<TComps...>, TFilters>
+    {
+      public:
         /**
          * @brief Update virtual function to be overriten by a System implementation.
          *  Called by the \see{BaseSystem} class through \see{SystemManager} command.
          *  
          * @param deltaTime Timespan between last and current frame (in seconds).
          */
-        inline virtual void beforeUpdate(double deltaTime){};
+        inline virtual void beforeUpdate(double /*deltaTime*/){};
 
         /**
          * @brief Update virtual function to be overriten by a System implementation.
@@ -106,7 +420,7 @@ namespace rv
          *  
          * @param deltaTime Timespan between last and current frame (in seconds).
          */
-        inline virtual void afterUpdate(double deltaTime){};
+        inline virtual void afterUpdate(double /*deltaTime*/){};
 
         /**
          * @brief Update virtual function to be overriten by a System implementation.
@@ -116,8 +430,8 @@ namespace rv
          * @param batchSize Amount of entities the components represent.
          * @param components List expansion for each component type this system runs through.
          */
-        inline virtual void update(double deltaTime, int32_t offset, int32_t size, int32_t batchSize,
-                                   TComps* const... components)
+        inline virtual void update(double deltaTime, int32_t /*offset*/, int32_t /*size*/, int32_t batchSize,
+                                   ComponentPointer<TComps> const... components)
         {
             update(deltaTime, batchSize, components...);
         };
@@ -130,7 +444,180 @@ namespace rv
          * @param size Amount of entities the components represent.
          * @param components List expansion for each component type this system runs through.
          */
-        inline virtual void update(double deltaTime, int32_t batchSize, TComps* const... components){};
+        inline virtual void update(double /*deltaTime*/, int32_t /*batchSize*/,
+                                   ComponentPointer<TComps> const... /*components*/){};
+
+        /**
+         * @brief Kernel called by \see{QuerySystem} for each chunk, forwards to the virtual \see{update}.
+         */
+        inline void updateChunk(double deltaTime, int32_t offset, int32_t size, int32_t batchSize,
+                                ComponentPointer<TComps> const... components)
+        {
+            update(deltaTime, offset, size, batchSize, components...);
+        }
+    };
+
+    /**
+     * @brief System running through every entity with all the given component types.
+     * Types may be const (e.g. `BaseSystem<const CompA, CompB>`) to only read them, their chunks are then handed
+     * as `const T*`, from the same storage as the mutable type.
+     *
+     * Filters narrow down the matched archetypes, e.g. `BaseSystem<CompA, Without<Frozen>, Optional<CompB>>`:
+     * \see{Without} and \see{AnyOf} are only matched against archetype masks and are not handed to \see{update},
+     * \see{Optional} types are handed as nullptr chunks for the archetypes lacking them.
+     */
+    template <class... TArgs>
+    class BaseSystem
+        : public VirtualSystem<typename QueryArgs<TArgs...>::Components, typename QueryArgs<TArgs...>::Filters>
+    {
+    };
+
+    /**
+     * @brief Same as \see{BaseSystem}, but the derived class is the kernel itself (CRTP): the per-chunk update is
+     * resolved at compile time and can be inlined, leaving \see{ISystem::update} as the only virtual call per frame.
+     * The derived class defines either (public, non-virtual) \see{BaseSystem} update overload, and optionally its
+     * own beforeUpdate and afterUpdate functions, e.g.
+     * `class MoveSystem : public StaticSystem<MoveSystem, CompA, const CompB>`
+     * `{ public: void update(double deltaTime, int32_t batchSize, CompA* posArray, const CompB* velArray); };`
+     *
+     * @tparam TDerived Class deriving from this one.
+     */
+    template <class TDerived, class... TArgs>
+    class StaticSystem : public QuerySystem<TDerived, typename QueryArgs<TArgs...>::Components,
+                                            typename QueryArgs<TArgs...>::Filters>
+    {
+      private:
+        /**
+         * @brief Whether the derived class defines the update overload taking the chunk offset and size.
+         */
+        template <class T, class... TPointers>
+        inline static constexpr auto hasOffsetUpdate(int)
+            -> decltype((void)std::declval<T&>().update(0.0, std::declval<int32_t>(), std::declval<int32_t>(),
+                                                        std::declval<int32_t>(), std::declval<TPointers>()...),
+                        bool())
+        {
+            return true;
+        }
+
+        template <class T, class... TPointers>
+        inline static constexpr bool hasOffsetUpdate(...)
+        {
+            return false;
+        }
+
+      public:
+        inline void beforeUpdate(double /*deltaTime*/) {}
+
+        inline void afterUpdate(double /*deltaTime*/) {}
+
+        /**
+         * @brief Kernel called by \see{QuerySystem} for each chunk, calls the derived update overload directly.
+         */
+        template <class... TPointers>
+        inline void updateChunk(double deltaTime, int32_t offset, int32_t size, int32_t batchSize,
+                                TPointers const... components)
+        {
+            TDerived& derived = static_cast<TDerived&>(*this);
+            if constexpr (hasOffsetUpdate<TDerived, TPointers...>(0))
+            {
+                derived.update(deltaTime, offset, size, batchSize, components...);
+            }
+            else
+            {
+                derived.update(deltaTime, batchSize, components...);
+            }
+        }
+    };
+
+    /**
+     * @brief Chunk handed to the kernel of an \see{AlignedSystem}, its component arrays start at RV_COMPONENT_ALIGN
+     * bytes boundaries and are padded to a multiple of RV_CHUNK_LANES entities.
+     * Padding lanes are group slack (zeroed once allocated), they can be read and written but hold no entity.
+     */
+    struct AlignedChunk
+    {
+        static constexpr int32_t lanes = RV_CHUNK_LANES;
+
+        /**
+         * @brief Amount of blocks of lanes, the last one may be partially valid.
+         */
+        int32_t blocks;
+        /**
+         * @brief Amount of valid entities, the first ones of the chunk.
+         */
+        int32_t size;
+
+        /**
+         * @brief Length of the arrays, a multiple of lanes known at compile time to be so.
+         */
+        constexpr int32_t paddedSize() const { return blocks * lanes; }
+
+        /**
+         * @brief Mask of the valid lanes of the given block, e.g. for masked stores of the last one.
+         */
+        constexpr uint32_t laneMask(const int32_t block) const
+        {
+            const int32_t valid = size - block * lanes;
+            return valid >= lanes ? UINT32_MAX >> (32 - lanes) : (valid <= 0 ? 0u : (1u << valid) - 1);
+        }
+    };
+
+    /**
+     * @brief Same as \see{StaticSystem}, but the chunks are aligned and padded (\see{AlignedChunk}) so kernels
+     * auto-vectorize without scalar prologue nor epilogue. Every fetched type needs the group layout (a single run
+     * per group, starting at an aligned page), e.g.
+     * `class MoveSystem : public AlignedSystem<MoveSystem, CompA, const CompB>`
+     * `{ public: void update(double deltaTime, const AlignedChunk& chunk, CompA* posArray, const CompB* velArray); };`
+     * whose loop runs through `chunk.paddedSize()` entities.
+     *
+     * @tparam TDerived Class deriving from this one.
+     */
+    template <class TDerived, class... TArgs>
+    class AlignedSystem : public QuerySystem<TDerived, typename QueryArgs<TArgs...>::Components,
+                                             typename QueryArgs<TArgs...>::Filters>
+    {
+      private:
+        /**
+         * @brief Checks a fetched type keeps its chunks aligned.
+         */
+        template <class TComponent>
+        struct AlignedType
+        {
+            using Type = ComponentType<TComponent>;
+            static_assert(!ComponentStorage<Type>::shared,
+                          "Aligned systems need the group layout, see ComponentTraits<T>::Layout");
+            static_assert((RV_CHUNK_LANES * sizeof(Type)) % RV_COMPONENT_ALIGN == 0,
+                          "Every block of RV_CHUNK_LANES components must be a multiple of RV_COMPONENT_ALIGN bytes");
+            static constexpr bool value = true;
+        };
+
+        template <class TComponents>
+        struct AlignedTypes;
+
+        template <class... TComps>
+        struct AlignedTypes<TypeList<TComps...>>
+        {
+            static constexpr bool value = (true && ... && AlignedType<TComps>::value);
+        };
+
+        static_assert(AlignedTypes<typename QueryArgs<TArgs...>::Components>::value, "Unaligned component types");
+        static_assert(RV_CHANGE_BLOCK % RV_CHUNK_LANES == 0, "Change blocks must be a multiple of RV_CHUNK_LANES");
+
+      public:
+        inline void beforeUpdate(double /*deltaTime*/) {}
+
+        inline void afterUpdate(double /*deltaTime*/) {}
+
+        /**
+         * @brief Kernel called by \see{QuerySystem} for each chunk, pads it and calls the derived update directly.
+         */
+        template <class... TPointers>
+        inline void updateChunk(double deltaTime, int32_t /*offset*/, int32_t /*size*/, int32_t batchSize,
+                                TPointers const... components)
+        {
+            const AlignedChunk chunk = {(batchSize + AlignedChunk::lanes - 1) / AlignedChunk::lanes, batchSize};
+            static_cast<TDerived&>(*this).update(deltaTime, chunk, assumeAligned(components)...);
+        }
     };
 
 } // namespace rv
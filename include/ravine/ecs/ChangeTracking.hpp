@@ -0,0 +1,48 @@
+#ifndef CHANGETRACKING_HPP
+#define CHANGETRACKING_HPP
+
+#include <atomic>
+#include <stdint.h>
+
+#include "ComponentTraits.hpp"
+#include "FastMath.h"
+
+namespace rv
+{
+    /**
+     * @brief Clock of component writes, every group keeps the version of the last write of each block of
+     * RV_CHANGE_BLOCK components. Each system run takes a new version and stamps the mutable chunks it is handed,
+     * so a block changed since a system last ran has a newer version than that run.
+     */
+    class ChangeTracking
+    {
+      public:
+        static_assert((RV_CHANGE_BLOCK & (RV_CHANGE_BLOCK - 1)) == 0, "Change blocks must be a power of two");
+
+        static constexpr int32_t blockShift = log2Floor(RV_CHANGE_BLOCK);
+
+        inline static std::atomic<uint32_t>& clock()
+        {
+            static std::atomic<uint32_t> version(0);
+            return version;
+        }
+
+        /**
+         * @brief Starts a system run, returning the version its writes are stamped with.
+         */
+        inline static uint32_t nextRun() { return clock().fetch_add(1, std::memory_order_relaxed) + 1; }
+
+        /**
+         * @brief Version of the writes made outside of systems, newer than every run so far.
+         */
+        inline static uint32_t pending() { return clock().load(std::memory_order_relaxed) + 1; }
+
+        /**
+         * @brief Amount of components from the given id to the end of its block.
+         */
+        constexpr static int32_t blockRun(const int32_t id) { return RV_CHANGE_BLOCK - (id & (RV_CHANGE_BLOCK - 1)); }
+    };
+
+} // namespace rv
+
+#endif
\ No newline at end of file
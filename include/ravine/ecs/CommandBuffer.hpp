@@ -0,0 +1,363 @@
+#ifndef COMMANDBUFFER_HPP
+#define COMMANDBUFFER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "EntitiesManager.hpp"
+
+namespace rv
+{
+    /**
+     * @brief Commands of a single kind (and component types) recorded by a \see{CommandBuffer}.
+     */
+    class ICommandBatch
+    {
+      public:
+        virtual ~ICommandBatch() = default;
+        /**
+         * @brief Moves the commands of another batch of the same kind to the end of this one.
+         */
+        virtual void append(ICommandBatch* other) = 0;
+        /**
+         * @brief Applies all the commands as a single bulk operation, then clears them.
+         */
+        virtual void playback() = 0;
+        virtual bool empty() const = 0;
+    };
+
+    template <class... TComponents>
+    class CreateBatch final : public ICommandBatch
+    {
+      private:
+        int32_t count = 0;
+        tuple<std::vector<TComponents>...> values;
+
+      public:
+        inline void push(const TComponents&... comps)
+        {
+            using expander = int[];
+            expander{0, ((void)(std::get<std::vector<TComponents>>(values).push_back(comps)), 0)...};
+            count++;
+        }
+
+        void append(ICommandBatch* other) final
+        {
+            using expander = int[];
+            CreateBatch* batch = (CreateBatch*)other;
+            expander{0, ((void)(std::get<std::vector<TComponents>>(values).insert(
+                             std::get<std::vector<TComponents>>(values).end(),
+                             std::get<std::vector<TComponents>>(batch->values).begin(),
+                             std::get<std::vector<TComponents>>(batch->values).end())),
+                         (void)(std::get<std::vector<TComponents>>(batch->values).clear()), 0)...};
+            count += batch->count;
+            batch->count = 0;
+        }
+
+        void playback() final
+        {
+            using expander = int[];
+            delete[] EntitiesManager::createEntities<TComponents...>(
+                count, (const TComponents*)std::get<std::vector<TComponents>>(values).data()...);
+            expander{0, ((void)(std::get<std::vector<TComponents>>(values).clear()), 0)...};
+            count = 0;
+        }
+
+        bool empty() const final { return count == 0; }
+    };
+
+    /**
+     * @brief Additions and removals of a component type, only the last one recorded for each entity is applied.
+     */
+    template <class TComponent>
+    class ComponentBatch final : public ICommandBatch
+    {
+      private:
+        struct Command
+        {
+            Entity entity;
+            /**
+             * @brief Recording order of the command in the batch (merged batches keep their order).
+             */
+            int32_t sequence;
+            /**
+             * @brief Index of the added value, -1 for removals.
+             */
+            int32_t valueId;
+        };
+
+        std::vector<Command> commands;
+        std::vector<TComponent> values;
+
+      public:
+        inline void pushAdd(const Entity entity, const TComponent& value)
+        {
+            commands.push_back({entity, (int32_t)commands.size(), (int32_t)values.size()});
+            values.push_back(value);
+        }
+
+        inline void pushRemove(const Entity entity) { commands.push_back({entity, (int32_t)commands.size(), -1}); }
+
+        void append(ICommandBatch* other) final
+        {
+            ComponentBatch* batch = (ComponentBatch*)other;
+            const int32_t sequenceBase = (int32_t)commands.size();
+            const int32_t valueBase = (int32_t)values.size();
+            for (const Command& command : batch->commands)
+            {
+                commands.push_back({command.entity, sequenceBase + command.sequence,
+                                    command.valueId < 0 ? -1 : valueBase + command.valueId});
+            }
+            values.insert(values.end(), batch->values.begin(), batch->values.end());
+            batch->commands.clear();
+            batch->values.clear();
+        }
+
+        void playback() final
+        {
+            // Sort by handle, then by recording order
+            std::sort(commands.begin(), commands.end(), [](const Command& a, const Command& b) {
+                if (a.entity.id != b.entity.id)
+                {
+                    return a.entity.id < b.entity.id;
+                }
+                return a.entity.generation != b.entity.generation ? a.entity.generation < b.entity.generation
+                                                                  : a.sequence < b.sequence;
+            });
+
+            // Keep the last command recorded for each entity
+            const int32_t count = (int32_t)commands.size();
+            Entity* addEntities = new Entity[count];
+            std::vector<TComponent> addValues;
+            addValues.reserve(count);
+            Entity* remEntities = new Entity[count];
+            int32_t addCount = 0;
+            int32_t remCount = 0;
+            for (int32_t i = 0; i < count; i++)
+            {
+                const Command& command = commands[i];
+                if (i + 1 < count && commands[i + 1].entity.id == command.entity.id &&
+                    commands[i + 1].entity.generation == command.entity.generation)
+                {
+                    continue;
+                }
+                if (command.valueId < 0)
+                {
+                    remEntities[remCount++] = command.entity;
+                }
+                else
+                {
+                    addEntities[addCount++] = command.entity;
+                    addValues.push_back(values[command.valueId]);
+                }
+            }
+
+            EntitiesManager::removeComponents<TComponent>(remEntities, remCount);
+            EntitiesManager::addComponents<TComponent>(addEntities, addCount, addValues.data());
+
+            delete[] remEntities;
+            delete[] addEntities;
+            commands.clear();
+            values.clear();
+        }
+
+        bool empty() const final { return commands.empty(); }
+    };
+
+    /**
+     * @brief Records structural changes (e.g. from inside a system update, while groups are being iterated) and
+     * applies them later at a sync point, as a single bulk operation per archetype or component type.
+     *
+     * Each thread should record into its own buffer, buffers are merged at playback without any locks.
+     * Playback runs in phases: destructions, component changes and then creations. So commands of a destroyed
+     * entity are skipped, and only the last addition (or removal) of a type recorded for an entity is applied.
+     */
+    class CommandBuffer
+    {
+      private:
+        std::vector<Entity> destructions;
+        /**
+         * @brief Batches of each component type (indexed by type id), nullptr until recorded.
+         */
+        std::vector<ICommandBatch*> changes;
+        /**
+         * @brief Batches of each set of component types (indexed by pack id), nullptr until recorded.
+         */
+        std::vector<ICommandBatch*> creations;
+
+        inline static std::atomic<int32_t>& packCounter()
+        {
+            static std::atomic<int32_t> packsCount(0);
+            return packsCount;
+        }
+
+        /**
+         * @brief Returns a dense id for each set of component types a buffer creates entities with.
+         */
+        template <class... TComponents>
+        inline static int32_t packId()
+        {
+            static const int32_t id = packCounter()++;
+            return id;
+        }
+
+        template <class TBatch>
+        inline static TBatch* getBatch(std::vector<ICommandBatch*>& batches, int32_t id);
+
+        /**
+         * @brief Merges the batches of all buffers into the first one with commands, then plays it back.
+         */
+        inline static void playback(std::vector<ICommandBatch*> CommandBuffer::*batches, CommandBuffer* buffers,
+                                    int32_t count);
+
+      public:
+        CommandBuffer() = default;
+        CommandBuffer(CommandBuffer&&) = default;
+        CommandBuffer(const CommandBuffer&) = delete;
+        CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+        ~CommandBuffer()
+        {
+            for (std::vector<ICommandBatch*>* batches : {&changes, &creations})
+            {
+                for (ICommandBatch* batch : *batches)
+                {
+                    delete batch;
+                }
+            }
+        }
+
+        /**
+         * @brief Records the creation of an entity, its handle is only known once played back.
+         */
+        template <class... TComponents>
+        inline void createEntity(const TComponents&... values);
+
+        /**
+         * @brief Records the removal of an entity, stale (or repeated) handles are ignored at playback.
+         */
+        inline void destroyEntity(Entity entity);
+
+        /**
+         * @brief Records the addition of a component, overriding the additions (or removals) of the type recorded
+         * before for the entity. Buffers played back together are merged in their order.
+         */
+        template <class TComponent>
+        inline void addComponent(Entity entity, const TComponent& value = TComponent());
+
+        /**
+         * @brief Records the removal of a component, overriding the additions of the type recorded before.
+         */
+        template <class TComponent>
+        inline void removeComponent(Entity entity);
+
+        /**
+         * @brief Applies and clears the recorded commands, must be called outside of any system update.
+         */
+        inline void playback();
+
+        /**
+         * @brief Applies and clears the commands of many buffers (e.g. one per thread), merging them per phase.
+         *
+         * @param buffers List of buffers, no longer being recorded into.
+         * @param count Size of the given buffers list.
+         */
+        inline static void playback(CommandBuffer* buffers, int32_t count);
+    };
+
+    template <class TBatch>
+    inline TBatch* CommandBuffer::getBatch(std::vector<ICommandBatch*>& batches, const int32_t id)
+    {
+        if (id >= (int32_t)batches.size())
+        {
+            batches.resize(id + 1, nullptr);
+        }
+        if (batches[id] == nullptr)
+        {
+            batches[id] = new TBatch();
+        }
+        return (TBatch*)batches[id];
+    }
+
+    template <class... TComponents>
+    inline void CommandBuffer::createEntity(const TComponents&... values)
+    {
+        getBatch<CreateBatch<TComponents...>>(creations, packId<TComponents...>())->push(values...);
+    }
+
+    inline void CommandBuffer::destroyEntity(const Entity entity)
+    {
+        destructions.push_back(entity);
+    }
+
+    template <class TComponent>
+    inline void CommandBuffer::addComponent(const Entity entity, const TComponent& value)
+    {
+        getBatch<ComponentBatch<TComponent>>(changes, ComponentTypes::id<TComponent>())->pushAdd(entity, value);
+    }
+
+    template <class TComponent>
+    inline void CommandBuffer::removeComponent(const Entity entity)
+    {
+        getBatch<ComponentBatch<TComponent>>(changes, ComponentTypes::id<TComponent>())->pushRemove(entity);
+    }
+
+    inline void CommandBuffer::playback()
+    {
+        playback(this, 1);
+    }
+
+    inline void CommandBuffer::playback(std::vector<ICommandBatch*> CommandBuffer::*batches,
+                                        CommandBuffer* buffers, const int32_t count)
+    {
+        int32_t batchesCount = 0;
+        for (int32_t i = 0; i < count; i++)
+        {
+            batchesCount = max(batchesCount, (int32_t)(buffers[i].*batches).size());
+        }
+        for (int32_t id = 0; id < batchesCount; id++)
+        {
+            ICommandBatch* target = nullptr;
+            for (int32_t i = 0; i < count; i++)
+            {
+                const std::vector<ICommandBatch*>& bufferBatches = buffers[i].*batches;
+                ICommandBatch* batch = id < (int32_t)bufferBatches.size() ? bufferBatches[id] : nullptr;
+                if (batch == nullptr || batch->empty())
+                {
+                    continue;
+                }
+                if (target == nullptr)
+                {
+                    target = batch;
+                }
+                else
+                {
+                    target->append(batch);
+                }
+            }
+            if (target != nullptr)
+            {
+                target->playback();
+            }
+        }
+    }
+
+    inline void CommandBuffer::playback(CommandBuffer* buffers, const int32_t count)
+    {
+        std::vector<Entity>& destructions = buffers[0].destructions;
+        for (int32_t i = 1; i < count; i++)
+        {
+            destructions.insert(destructions.end(), buffers[i].destructions.begin(), buffers[i].destructions.end());
+            buffers[i].destructions.clear();
+        }
+        EntitiesManager::destroyEntities(destructions.data(), (int32_t)destructions.size());
+        destructions.clear();
+
+        playback(&CommandBuffer::changes, buffers, count);
+        playback(&CommandBuffer::creations, buffers, count);
+    }
+
+} // namespace rv
+
+#endif
\ No newline at end of file
@@ -0,0 +1,267 @@
+#ifndef COMMANDQUEUE_HPP
+#define COMMANDQUEUE_HPP
+
+#include <atomic>
+#include <new>
+#include <stddef.h>
+#include <stdlib.h>
+#include <tuple>
+#include <vector>
+
+#include "CommandBuffer.hpp"
+
+namespace rv
+{
+    /**
+     * @brief Lock-free multi-producer single-consumer queue of structural changes.
+     * Worker threads record through their own \see{Producer}, the main thread drains the queue at frame
+     * boundaries (while no producer is recording), playing all commands back in bulk through a \see{CommandBuffer}.
+     *
+     * Commands are copied into the producer memory as is, so components must be trivially copyable.
+     */
+    class CommandQueue
+    {
+      private:
+        struct Command
+        {
+            Command* next;
+            /**
+             * @brief Records the command payload (right after the command) into the consumer buffer.
+             */
+            void (*record)(CommandBuffer& buffer, const Command* command);
+        };
+
+        template <class TPayload>
+        struct TypedCommand : Command
+        {
+            TPayload payload;
+        };
+
+      public:
+        /**
+         * @brief Records commands of a single thread, payloads are bump-allocated from blocks owned by the producer.
+         * Blocks (aligned to RV_COMPONENT_ALIGN bytes) are reused once the queue is drained.
+         */
+        class Producer
+        {
+            friend class CommandQueue;
+
+          private:
+            static constexpr size_t blockSize = 64 * 1024;
+
+            CommandQueue& queue;
+            Producer* next = nullptr;
+            std::vector<char*> blocks;
+            int32_t blockId = -1;
+            size_t offset = blockSize;
+
+            inline Producer(CommandQueue& queue) : queue(queue) {}
+
+            ~Producer()
+            {
+                for (char* block : blocks)
+                {
+                    alignedFree(block);
+                }
+            }
+
+            /**
+             * @brief Bump-allocates a slot of the given size and alignment (at most RV_COMPONENT_ALIGN bytes).
+             */
+            inline void* allocate(size_t size, size_t alignment);
+
+            template <class TPayload>
+            inline void push(void (*record)(CommandBuffer&, const Command*), const TPayload& payload);
+
+            /**
+             * @brief Rewinds to the first block, once all commands were played back.
+             */
+            inline void reset()
+            {
+                blockId = blocks.empty() ? -1 : 0;
+                offset = blocks.empty() ? blockSize : 0;
+            }
+
+          public:
+            Producer(const Producer&) = delete;
+            Producer& operator=(const Producer&) = delete;
+
+            template <class... TComponents>
+            inline void createEntity(const TComponents&... values);
+
+            inline void destroyEntity(Entity entity);
+
+            template <class TComponent>
+            inline void addComponent(Entity entity, const TComponent& value = TComponent());
+
+            template <class TComponent>
+            inline void removeComponent(Entity entity);
+        };
+
+      private:
+        /**
+         * @brief Last pushed command, commands are linked from the newest to the oldest.
+         */
+        std::atomic<Command*> head;
+        std::atomic<Producer*> producers;
+        CommandBuffer buffer;
+
+        inline void push(Command* command);
+
+      public:
+        inline CommandQueue() : head(nullptr), producers(nullptr) {}
+
+        CommandQueue(const CommandQueue&) = delete;
+        CommandQueue& operator=(const CommandQueue&) = delete;
+
+        ~CommandQueue()
+        {
+            Producer* producer = producers.load();
+            while (producer != nullptr)
+            {
+                Producer* next = producer->next;
+                delete producer;
+                producer = next;
+            }
+        }
+
+        /**
+         * @brief Creates a producer for the calling thread, owned by the queue. Thread-safe (lock-free).
+         */
+        inline Producer* createProducer();
+
+        /**
+         * @brief Plays back all the queued commands in the order they were pushed, must not run concurrently with
+         * any producer.
+         *
+         * @return int32_t Amount of commands played back.
+         */
+        inline int32_t drain();
+    };
+
+    inline void* CommandQueue::Producer::allocate(const size_t size, const size_t alignment)
+    {
+        _ASSERT(size <= blockSize && alignment <= RV_COMPONENT_ALIGN);
+        offset = (offset + alignment - 1) & ~(alignment - 1);
+        if (offset + size > blockSize)
+        {
+            // Move to the next block, allocating it the first time
+            blockId++;
+            if (blockId == (int32_t)blocks.size())
+            {
+                blocks.push_back((char*)alignedAlloc(blockSize));
+            }
+            offset = 0;
+        }
+        void* memory = blocks[blockId] + offset;
+        offset += size;
+        return memory;
+    }
+
+    template <class TPayload>
+    inline void CommandQueue::Producer::push(void (*record)(CommandBuffer&, const Command*), const TPayload& payload)
+    {
+        using Typed = TypedCommand<TPayload>;
+        static_assert(alignof(Typed) <= RV_COMPONENT_ALIGN, "Payloads can't be aligned beyond the producer blocks");
+        Typed* command = new (allocate(sizeof(Typed), alignof(Typed))) Typed();
+        command->record = record;
+        command->payload = payload;
+        queue.push(command);
+    }
+
+    template <class... TComponents>
+    inline void CommandQueue::Producer::createEntity(const TComponents&... values)
+    {
+        using Payload = std::tuple<TComponents...>;
+        push<Payload>(
+            [](CommandBuffer& buffer, const Command* command) {
+                const Payload& payload = ((const TypedCommand<Payload>*)command)->payload;
+                buffer.createEntity<TComponents...>(std::get<TComponents>(payload)...);
+            },
+            Payload(values...));
+    }
+
+    inline void CommandQueue::Producer::destroyEntity(const Entity entity)
+    {
+        push<Entity>(
+            [](CommandBuffer& buffer, const Command* command) {
+                buffer.destroyEntity(((const TypedCommand<Entity>*)command)->payload);
+            },
+            entity);
+    }
+
+    template <class TComponent>
+    inline void CommandQueue::Producer::addComponent(const Entity entity, const TComponent& value)
+    {
+        using Payload = std::tuple<Entity, TComponent>;
+        push<Payload>(
+            [](CommandBuffer& buffer, const Command* command) {
+                const Payload& payload = ((const TypedCommand<Payload>*)command)->payload;
+                buffer.addComponent<TComponent>(std::get<0>(payload), std::get<1>(payload));
+            },
+            Payload(entity, value));
+    }
+
+    template <class TComponent>
+    inline void CommandQueue::Producer::removeComponent(const Entity entity)
+    {
+        push<Entity>(
+            [](CommandBuffer& buffer, const Command* command) {
+                buffer.removeComponent<TComponent>(((const TypedCommand<Entity>*)command)->payload);
+            },
+            entity);
+    }
+
+    inline void CommandQueue::push(Command* command)
+    {
+        Command* last = head.load(std::memory_order_relaxed);
+        do
+        {
+            command->next = last;
+        } while (!head.compare_exchange_weak(last, command, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    inline CommandQueue::Producer* CommandQueue::createProducer()
+    {
+        Producer* producer = new Producer(*this);
+        Producer* last = producers.load(std::memory_order_relaxed);
+        do
+        {
+            producer->next = last;
+        } while (!producers.compare_exchange_weak(last, producer, std::memory_order_release,
+                                                  std::memory_order_relaxed));
+        return producer;
+    }
+
+    inline int32_t CommandQueue::drain()
+    {
+        // Take every queued command at once, then restore the push order
+        Command* command = head.exchange(nullptr, std::memory_order_acquire);
+        Command* first = nullptr;
+        while (command != nullptr)
+        {
+            Command* next = command->next;
+            command->next = first;
+            first = command;
+            command = next;
+        }
+
+        int32_t count = 0;
+        for (command = first; command != nullptr; command = command->next, count++)
+        {
+            command->record(buffer, command);
+        }
+        buffer.playback();
+
+        // Payloads are no longer needed
+        for (Producer* producer = producers.load(std::memory_order_acquire); producer != nullptr;
+             producer = producer->next)
+        {
+            producer->reset();
+        }
+        return count;
+    }
+
+} // namespace rv
+
+#endif
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef COMPONENTEVENTS_HPP
+#define COMPONENTEVENTS_HPP
+
+#include <algorithm>
+#include <vector>
+
+#include "Archetype.hpp"
+#include "EntitiesTable.hpp"
+#include "Entity.hpp"
+
+namespace rv
+{
+    /**
+     * @brief Entities that gained or lost a component type, batched per frame.
+     * Events are recorded by every structural change (creations, destructions and migrations) once the stream of
+     * a type is first used, then published (deduplicated) at each frame sync point.
+     */
+    struct ComponentEvents
+    {
+        /**
+         * @brief Events recorded since the last sync, in no particular order and possibly repeated.
+         */
+        std::vector<Entity> added;
+        std::vector<Entity> removed;
+        /**
+         * @brief Events published by the last sync, sorted by handle.
+         */
+        std::vector<Entity> frameAdded;
+        std::vector<Entity> frameRemoved;
+
+        /**
+         * @brief Amount of types whose events are recorded, structural changes skip recording while zero.
+         */
+        inline static int32_t& enabledCount()
+        {
+            static int32_t count = 0;
+            return count;
+        }
+
+        /**
+         * @brief Publishes the recorded events, keeping a single event per entity.
+         * Added entities must still have the type, removed ones must no longer have it (or be destroyed).
+         *
+         * @param typeId Type id of the events.
+         */
+        inline void publish(int32_t typeId);
+    };
+
+    inline void ComponentEvents::publish(const int32_t typeId)
+    {
+        EntitiesTable* table = EntitiesTable::getInstance();
+        auto sortUnique = [](std::vector<Entity>& entities) {
+            std::sort(entities.begin(), entities.end(), [](const Entity& a, const Entity& b) {
+                return a.id != b.id ? a.id < b.id : a.generation < b.generation;
+            });
+            entities.erase(std::unique(entities.begin(), entities.end(),
+                                       [](const Entity& a, const Entity& b) {
+                                           return a.id == b.id && a.generation == b.generation;
+                                       }),
+                           entities.end());
+        };
+        auto hasType = [table, typeId](const Entity& entity) {
+            return table->isValid(entity) && (*table)[entity.id].archetype->hasType(typeId);
+        };
+
+        frameAdded.swap(added);
+        frameRemoved.swap(removed);
+        added.clear();
+        removed.clear();
+        sortUnique(frameAdded);
+        sortUnique(frameRemoved);
+        frameAdded.erase(std::remove_if(frameAdded.begin(), frameAdded.end(),
+                                        [&hasType](const Entity& entity) { return !hasType(entity); }),
+                         frameAdded.end());
+        frameRemoved.erase(std::remove_if(frameRemoved.begin(), frameRemoved.end(), hasType), frameRemoved.end());
+    }
+
+} // namespace rv
+
+#endif
\ No newline at end of file
@@ -0,0 +1,301 @@
+#ifndef COMPONENTPAGES_HPP
+#define COMPONENTPAGES_HPP
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+#include "ComponentTraits.hpp"
+#include "FastMath.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#define RV_HAS_VM_RESERVE 1
+#else
+#define RV_HAS_VM_RESERVE 0
+#endif
+
+namespace rv
+{
+    static_assert((RV_COMPONENT_ALIGN & (RV_COMPONENT_ALIGN - 1)) == 0, "Component alignment must be a power of two");
+    static_assert((RV_CHUNK_LANES & (RV_CHUNK_LANES - 1)) == 0 && RV_CHUNK_LANES <= 32,
+                  "Chunk lanes must be a power of two, up to 32");
+
+    /**
+     * @brief Allocates memory aligned to RV_COMPONENT_ALIGN bytes, released with \see{alignedFree}.
+     */
+    inline void* alignedAlloc(const size_t bytes)
+    {
+#if defined(_MSC_VER)
+        return _aligned_malloc(bytes, RV_COMPONENT_ALIGN);
+#else
+        // Size must be a multiple of the alignment
+        return aligned_alloc(RV_COMPONENT_ALIGN, (bytes + RV_COMPONENT_ALIGN - 1) & ~size_t(RV_COMPONENT_ALIGN - 1));
+#endif
+    }
+
+    inline void alignedFree(void* data)
+    {
+#if defined(_MSC_VER)
+        _aligned_free(data);
+#else
+        free(data);
+#endif
+    }
+
+    /**
+     * @brief Tells the compiler the given component array is aligned to RV_COMPONENT_ALIGN bytes.
+     */
+    template <class T>
+    inline T* assumeAligned(T* const data)
+    {
+        _ASSERT(((uintptr_t)data & (RV_COMPONENT_ALIGN - 1)) == 0);
+#if defined(_MSC_VER)
+        __assume(((uintptr_t)data & (RV_COMPONENT_ALIGN - 1)) == 0);
+        return data;
+#else
+        return static_cast<T*>(__builtin_assume_aligned(data, RV_COMPONENT_ALIGN));
+#endif
+    }
+
+    /**
+     * @brief Memory of a component storage, addressed by position through a table of pages.
+     * Contiguous storages have a single page, which is reallocated on growth (or grown in place if reserved).
+     * Pages are aligned to RV_COMPONENT_ALIGN bytes and hold a multiple of RV_CHUNK_LANES components, slots beyond
+     * the used ones are zeroed when allocated.
+     */
+    template <class TComponent>
+    struct ComponentPages
+    {
+        static constexpr bool paged = ComponentTraits<TComponent>::paged;
+        static constexpr bool reserved = !paged && ComponentTraits<TComponent>::reserved && RV_HAS_VM_RESERVE;
+        /**
+         * @brief Granularity (in bytes) of reserved memory, the size of a huge page.
+         */
+        static constexpr size_t reserveAlign = size_t(2) << 20;
+        static constexpr int32_t pageShift =
+            paged ? log2Floor(max(RV_CHUNK_LANES, ComponentTraits<TComponent>::pageBytes / (int32_t)sizeof(TComponent)))
+                  : 30;
+        static constexpr int32_t pageSize = 1 << pageShift;
+        static constexpr int32_t pageMask = pageSize - 1;
+
+        TComponent** pages = nullptr;
+        int32_t pagesCount = 0;
+        int32_t capacity = 0;
+        /**
+         * @brief Size (in bytes) of the reserved range, only used by reserved storages.
+         */
+        size_t reservedBytes = 0;
+
+        inline ComponentPages(const int32_t minCapacity) { grow(minCapacity); }
+
+        ~ComponentPages()
+        {
+#if RV_HAS_VM_RESERVE
+            if (reserved && pagesCount > 0)
+            {
+                munmap(pages[0], reservedBytes);
+                pagesCount = 0;
+            }
+#endif
+            for (int32_t i = 0; i < pagesCount; i++)
+            {
+                alignedFree(pages[i]);
+            }
+            free(pages);
+        }
+
+        inline TComponent* at(const int32_t pos) const { return pages[pos >> pageShift] + (pos & pageMask); }
+
+        /**
+         * @brief Amount of positions from the given one until the end of its page.
+         */
+        constexpr static int32_t pageRun(const int32_t pos) { return pageSize - (pos & pageMask); }
+
+        /**
+         * @brief Grows the capacity beyond the given one.
+         * Paged storages add pages, contiguous ones reallocate (and copy) their single page.
+         * Reserved storages just extend their capacity within the reserved range, remapping it if exhausted.
+         */
+        inline void grow(int32_t minCapacity);
+
+        /**
+         * @brief Returns the memory beyond the used components to the system, after mass removals.
+         * Only reserved storages release memory, capacity may shrink.
+         *
+         * @param usedCount Amount of components in use (positions [0, usedCount) are kept).
+         */
+        inline void release(int32_t usedCount);
+
+        /**
+         * @brief Moves components between positions, ranges may overlap (same as memmove).
+         */
+        inline void move(int32_t dst, int32_t src, int32_t count);
+
+        /**
+         * @brief Copies components from a linear buffer into the given position.
+         */
+        inline void write(int32_t dst, const TComponent* src, int32_t count);
+
+        /**
+         * @brief Copies components from the given position into a linear buffer.
+         */
+        inline void read(TComponent* dst, int32_t src, int32_t count) const;
+    };
+
+    template <class TComponent>
+    inline void ComponentPages<TComponent>::grow(const int32_t minCapacity)
+    {
+#if RV_HAS_VM_RESERVE
+        if (reserved)
+        {
+            const int32_t newCapacity = alignUp((int32_t)(max(capacity, minCapacity) * 1.2f + 1), RV_CHUNK_LANES);
+            const size_t newBytes = size_t(newCapacity) * sizeof(TComponent);
+            if (pagesCount == 0)
+            {
+                // Reserve the whole range up front, pages are only committed once touched
+                const size_t reserveBytes = ComponentTraits<TComponent>::reserveBytes;
+                reservedBytes = reserveBytes > newBytes ? reserveBytes : newBytes;
+                reservedBytes = (reservedBytes + reserveAlign - 1) & ~(reserveAlign - 1);
+                void* range = mmap(nullptr, reservedBytes, PROT_READ | PROT_WRITE,
+                                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+                _ASSERT(range != MAP_FAILED);
+                madvise(range, reservedBytes, MADV_HUGEPAGE);
+                pages = (TComponent**)malloc(sizeof(TComponent*));
+                pages[0] = (TComponent*)range;
+                pagesCount = 1;
+            }
+            else if (newBytes > reservedBytes)
+            {
+                // Remap to a bigger range, the kernel moves the page tables instead of copying
+                const size_t newReserved = reservedBytes * 2 > newBytes ? reservedBytes * 2 : newBytes;
+                void* range = mremap(pages[0], reservedBytes, newReserved, MREMAP_MAYMOVE);
+                _ASSERT(range != MAP_FAILED);
+                madvise(range, newReserved, MADV_HUGEPAGE);
+                pages[0] = (TComponent*)range;
+                reservedBytes = newReserved;
+            }
+            capacity = newCapacity;
+            return;
+        }
+#endif
+
+        if (!paged)
+        {
+            const int32_t newCapacity = alignUp((int32_t)(max(capacity, minCapacity) * 1.2f + 1), RV_CHUNK_LANES);
+            TComponent* newData = (TComponent*)alignedAlloc(newCapacity * sizeof(TComponent));
+            if (pagesCount == 0)
+            {
+                pages = (TComponent**)malloc(sizeof(TComponent*));
+                pagesCount = 1;
+            }
+            else
+            {
+                memcpy(newData, pages[0], capacity * sizeof(TComponent));
+                alignedFree(pages[0]);
+            }
+            // Padded chunks read (and write) the slots past the last component
+            memset((void*)(newData + capacity), 0, (newCapacity - capacity) * sizeof(TComponent));
+            pages[0] = newData;
+            capacity = newCapacity;
+            return;
+        }
+
+        // Just add pages, existing ones stay in place
+        const int32_t newPagesCount = (minCapacity >> pageShift) + 1;
+        if (newPagesCount <= pagesCount)
+        {
+            return;
+        }
+        pages = (TComponent**)realloc(pages, newPagesCount * sizeof(TComponent*));
+        for (int32_t i = pagesCount; i < newPagesCount; i++)
+        {
+            pages[i] = (TComponent*)alignedAlloc(pageSize * sizeof(TComponent));
+            memset((void*)pages[i], 0, pageSize * sizeof(TComponent));
+        }
+        pagesCount = newPagesCount;
+        capacity = pagesCount << pageShift;
+    }
+
+    template <class TComponent>
+    inline void ComponentPages<TComponent>::release(const int32_t usedCount)
+    {
+#if RV_HAS_VM_RESERVE
+        if (!reserved)
+        {
+            return;
+        }
+
+        // Keep twice the used memory, only release once a quarter of the capacity is in use
+        const size_t usedBytes = size_t(usedCount) * sizeof(TComponent);
+        const size_t capacityBytes = size_t(capacity) * sizeof(TComponent);
+        const size_t keepBytes = (usedBytes * 2 + reserveAlign - 1) & ~(reserveAlign - 1);
+        if (usedBytes * 4 > capacityBytes || keepBytes >= capacityBytes)
+        {
+            return;
+        }
+        madvise((char*)pages[0] + keepBytes, capacityBytes - keepBytes, MADV_DONTNEED);
+        capacity = (int32_t)(keepBytes / sizeof(TComponent));
+#endif
+    }
+
+    template <class TComponent>
+    inline void ComponentPages<TComponent>::move(const int32_t dst, const int32_t src, const int32_t count)
+    {
+        if (count <= 0 || dst == src)
+        {
+            return;
+        }
+
+        if (dst < src)
+        {
+            // Move forward, a run at a time
+            for (int32_t done = 0; done < count;)
+            {
+                const int32_t run = min(count - done, min(pageRun(dst + done), pageRun(src + done)));
+                memmove(at(dst + done), at(src + done), run * sizeof(TComponent));
+                done += run;
+            }
+        }
+        else
+        {
+            // Move backward, a run at a time
+            for (int32_t left = count; left > 0;)
+            {
+                const int32_t dstLast = dst + left - 1;
+                const int32_t srcLast = src + left - 1;
+                const int32_t run = min(left, min((dstLast & pageMask) + 1, (srcLast & pageMask) + 1));
+                memmove(at(dstLast - run + 1), at(srcLast - run + 1), run * sizeof(TComponent));
+                left -= run;
+            }
+        }
+    }
+
+    template <class TComponent>
+    inline void ComponentPages<TComponent>::write(const int32_t dst, const TComponent* src, const int32_t count)
+    {
+        for (int32_t done = 0; done < count;)
+        {
+            const int32_t run = min(count - done, pageRun(dst + done));
+            memcpy(at(dst + done), src + done, run * sizeof(TComponent));
+            done += run;
+        }
+    }
+
+    template <class TComponent>
+    inline void ComponentPages<TComponent>::read(TComponent* dst, const int32_t src, const int32_t count) const
+    {
+        for (int32_t done = 0; done < count;)
+        {
+            const int32_t run = min(count - done, pageRun(src + done));
+            memcpy(dst + done, at(src + done), run * sizeof(TComponent));
+            done += run;
+        }
+    }
+
+} // namespace rv
+
+#endif
\ No newline at end of file
@@ -1,13 +1,17 @@
 #ifndef COMPONENTSTORAGE_HPP
 #define COMPONENTSTORAGE_HPP
 
+#include <algorithm>
 #include <map>
-#include <set>
 #include <stdlib.h>
 #include <string.h>
+#include <vector>
 
+#include "Archetype.hpp"
+#include "ComponentTypes.hpp"
 #include "ComponentsGroup.hpp"
 #include "ComponentsIterator.hpp"
+#include "GroupMask.hpp"
 #include "IComponentStorage.h"
 
 namespace rv
@@ -15,11 +19,6 @@ namespace rv
     // Empty Namespace to avoid leaking using directives
     namespace
     {
-        // Registry def
-        using GroupMaskSet = std::set<GroupMask, GroupMaskCmp>;
-        using GroupsRegistry = std::map<intptr_t, GroupMaskSet>;
-        using GroupRegPair = GroupsRegistry::value_type;
-        using GroupsRegIt = GroupsRegistry::iterator;
         // Groups Storage def
         template <typename TComp>
         using CompGroup = ComponentsGroup<TComp>;
@@ -29,161 +28,339 @@ namespace rv
         using GroupMaskPair = typename GroupsMap<TComp>::value_type;
         template <typename TComp>
         using GroupIt = typename GroupsMap<TComp>::iterator;
-
+        // Queries def
+        template <typename TComp>
+        using QueryGroups = std::vector<GroupIt<TComp>>;
         template <typename TComp>
+        using QueriesMap = std::map<GroupMask, QueryGroups<TComp>, GroupMaskCmp>;
+        template <typename TComp>
+        using QueryIt = typename QueriesMap<TComp>::iterator;
+
+        /**
+         * @brief Storage of all components of a type, split in groups (one per set of component types).
+         *
+         * @tparam TLayout \see{SharedLayout} packs all groups in the storage pages, \see{GroupLayout} gives each
+         * group its own pages.
+         */
+        template <typename TComp, class TLayout = typename ComponentTraits<TComp>::Layout>
         class ComponentStorage : public IComponentStorage
         {
 
           private:
+            // Slots reserved by all groups (their sizes plus slack), only used by the shared layout
             int32_t size = 0;
             int32_t capacity = 0;
 
           public:
-            TComp* data;
+            static constexpr bool shared = TLayout::shared;
+
+            /**
+             * @brief Pages shared by all groups, left empty by the group layout.
+             */
+            ComponentPages<TComp> pages;
+
+            /**
+             * @brief Dense id of the component type, its bit in every group mask.
+             */
+            const int32_t typeId;
+
+            /**
+             * @brief Structural version, incremented whenever groups are created, resized or moved around.
+             * Iterators built from this storage are outdated once the version changes.
+             */
+            uint32_t version = 0;
 
             /**
              * @brief Organized storage of groups based on their representative mask values.
              */
             GroupsMap<TComp> groups;
             /**
-             * @brief Organized storage of groups registry masks for each mask combination.
+             * @brief Groups matched by each registered query mask, kept in the same order as \see{groups}.
+             */
+            QueriesMap<TComp> queries;
+            /**
+             * @brief Cache of the group of each archetype (indexed by archetype id), groups.end() if not cached.
              */
-            GroupsRegistry groupsRegistry;
+            std::vector<GroupIt<TComp>> archetypeGroups;
 
-            constexpr ComponentStorage() : capacity(10), data((TComp*)malloc(10 * sizeof(TComp))) {}
+            inline ComponentStorage()
+                : pages(shared ? 10 : 0), typeId(ComponentTypes::id<TComp>())
+            {
+                capacity = pages.capacity;
+                ComponentTypes::storage(typeId) = this;
+            }
 
             ~ComponentStorage()
             {
-                free(data);
+                for (GroupMaskPair<TComp>& pair : groups)
+                {
+                    delete pair.second;
+                }
                 groups.clear();
                 capacity = 0;
             }
 
             inline void grow(int32_t newCapacity = 0);
 
-            inline CompGroupIt<TComp> getComponentIterator(const intptr_t mask);
+            /**
+             * @brief Rebuilds (in place) the iterator of all groups that have the given mask.
+             */
+            inline void getComponentIterator(const GroupMask& mask, CompGroupIt<TComp>& it);
+
+            /**
+             * @brief Rebuilds (in place) the iterator of the groups with the given masks, in the same order.
+             * Masks without a group in this storage get an empty iterator, handing nullptr chunks.
+             */
+            inline void getComponentIterator(const GroupMask* masks, int32_t count, CompGroupIt<TComp>& it);
 
             // TODO: Process many groups, each with different masks
-            inline CompGroup<TComp>* addComponent(const intptr_t* masks, const int32_t maskCount, const TComp* comps,
+            inline CompGroup<TComp>* addComponent(const int32_t* types, const int32_t typesCount, const TComp* comps,
                                                   int32_t count);
 
-            inline TComp* addComponent(const intptr_t* masks, const int32_t maskCount, const TComp& comp);
+            inline TComp* addComponent(const int32_t* types, const int32_t typesCount, const TComp& comp);
 
-            inline GroupIt<TComp> getComponentGroup(const intptr_t* masks, const int32_t maskCount);
+            inline CompGroup<TComp>* addComponent(const Archetype* archetype, const TComp* comps, int32_t count);
 
-            inline GroupsRegIt getRegistryEntryIt(const intptr_t mask);
+            inline CompGroup<TComp>* addComponent(GroupIt<TComp> groupIt, const TComp* comps, int32_t count);
 
-            inline static ComponentStorage<TComp>* getInstance();
+            /**
+             * @brief Removes components from a group, keeping the order of the remaining ones if asked to.
+             */
+            inline void removeComponents(GroupIt<TComp> groupIt, const int32_t* entityIds, int32_t count,
+                                         bool ordered);
 
-            void swapComponent(int32_t entityId, GroupMask oldTypeMask, GroupMask newTypeMask) final
+            inline GroupIt<TComp> getComponentGroup(const int32_t* types, const int32_t typesCount);
+
+            /**
+             * @brief Returns the group of the given archetype, without recomputing its mask once cached.
+             */
+            inline GroupIt<TComp> getArchetypeGroup(const Archetype* archetype);
+
+            /**
+             * @brief Returns the component of an entity, given its location.
+             *
+             * @param archetype Archetype of the entity, which must have this component type.
+             * @param entityId Id of the entity in its archetype groups.
+             * @return TComp* The component, constant time once the archetype group is cached.
+             */
+            inline TComp* getComponent(const Archetype* archetype, int32_t entityId);
+
+            /**
+             * @brief Returns the query of the given mask, registering it (and matching existing groups) once.
+             */
+            inline QueryIt<TComp> getQuery(const GroupMask& mask);
+
+            inline static ComponentStorage* getInstance();
+
+            void swapComponent(int32_t entityId, const Archetype* oldArchetype, const Archetype* newArchetype) final
             {
-                // TODO: Implement Swapping
+                swapComponents(&entityId, 1, oldArchetype, newArchetype);
             }
 
-            void removeComponent(int32_t entityId, GroupMask typeMask) final
-            {              
-                GroupIt<TComp> it = groups.find(typeMask);
-                _ASSERT(it != groups.end());
-                // Remove Component from specific group
-                (*it->second).remComponent(entityId);
-                // Roll all effected groups to fill the gap
-                for (it++; it != groups.end(); it++)
+            void swapComponents(const int32_t* entityIds, int32_t count, const Archetype* oldArchetype,
+                                const Archetype* newArchetype) final
+            {
+                GroupIt<TComp> oldIt = getArchetypeGroup(oldArchetype);
+                GroupIt<TComp> newIt = getArchetypeGroup(newArchetype);
+                // Hold components while their old group is compressed
+                TComp* comps = (TComp*)malloc(count * sizeof(TComp));
+                CompGroup<TComp>* oldGroup = oldIt->second;
+                for (int32_t i = 0; i < count; i++)
                 {
-                    (*it->second).rollCounterClockwise(1);
+                    comps[i] = *oldGroup->getComponent(entityIds[i]);
                 }
+                removeComponents(oldIt, entityIds, count, oldArchetype->ordered);
+                addComponent(newIt, comps, count);
+                free(comps);
             }
+
+            void removeComponent(int32_t entityId, const Archetype* archetype) final
+            {
+                removeComponents(getArchetypeGroup(archetype), &entityId, 1, archetype->ordered);
+            }
+
+            void removeComponents(const int32_t* entityIds, int32_t count, const Archetype* archetype) final
+            {
+                removeComponents(getArchetypeGroup(archetype), entityIds, count, archetype->ordered);
+            }
+
+            void compact() final;
         };
 
-        template <class TComp>
-        inline void ComponentStorage<TComp>::grow(int32_t newCapacity)
+        template <class TComp, class TLayout>
+        inline void ComponentStorage<TComp, TLayout>::grow(int32_t newCapacity)
         {
-            const int32_t grow = max(capacity, newCapacity) * 1.2f;
-            TComp* newData = (TComp*)malloc(grow * sizeof(TComp));
-            memcpy(newData, data, capacity * sizeof(TComp));
-            free(data);
-            data = newData;
-            capacity = grow;
+            pages.grow(newCapacity);
+            capacity = pages.capacity;
+            version++;
         }
 
-        template <class TComp>
-        inline CompGroupIt<TComp> ComponentStorage<TComp>::getComponentIterator(const intptr_t mask)
+        template <class TComp, class TLayout>
+        inline void ComponentStorage<TComp, TLayout>::getComponentIterator(const GroupMask& mask,
+                                                                           CompGroupIt<TComp>& it)
         {
-            // Check if registry entry exists
-            GroupsRegIt regIt = groupsRegistry.find(mask);
-            if (regIt == groupsRegistry.end())
+            // Fill Iterator
+            const QueryGroups<TComp>& queryGroups = getQuery(mask)->second;
+            it.reset((int32_t)queryGroups.size());
+            for (const GroupIt<TComp>& groupIt : queryGroups)
             {
-                return CompGroupIt<TComp>();
+                it.push(groupIt->second);
             }
+        }
 
-            // Create Iterator
-            const int32_t groupCount = regIt->second.size();
-            CompGroup<TComp>** groupsWithMask = new CompGroup<TComp>*[groupCount];
-            int32_t i = 0;
-            for (const GroupMask& mask : regIt->second)
+        template <class TComp, class TLayout>
+        inline void ComponentStorage<TComp, TLayout>::getComponentIterator(const GroupMask* masks,
+                                                                           const int32_t count, CompGroupIt<TComp>& it)
+        {
+            it.reset(count);
+            for (int32_t i = 0; i < count; i++)
             {
-                // Perform Groups Lookup
-                groupsWithMask[i] = groups[mask];
-                ++i;
+                const GroupIt<TComp> groupIt = groups.find(masks[i]);
+                if (groupIt != groups.end())
+                {
+                    it.push(groupIt->second);
+                }
+                else
+                {
+                    it.pushEmpty();
+                }
             }
-            CompGroupIt<TComp> it(groupsWithMask, groupCount, data);
+        }
 
-            // Safe to perform cleanup now
-            delete[] groupsWithMask;
+        // TODO: Process many groups, each with different masks
+        template <class TComp, class TLayout>
+        inline ComponentsGroup<TComp>* ComponentStorage<TComp, TLayout>::addComponent(const int32_t* types,
+                                                                                      const int32_t typesCount,
+                                                                                      const TComp* comps, int32_t count)
+        {
+            return addComponent(getComponentGroup(types, typesCount), comps, count);
+        }
 
-            return it;
+        template <class TComp, class TLayout>
+        inline ComponentsGroup<TComp>* ComponentStorage<TComp, TLayout>::addComponent(const Archetype* archetype,
+                                                                                      const TComp* comps, int32_t count)
+        {
+            return addComponent(getArchetypeGroup(archetype), comps, count);
         }
 
-        // TODO: Process many groups, each with different masks
-        template <class TComp>
-        inline ComponentsGroup<TComp>* ComponentStorage<TComp>::addComponent(const intptr_t* masks,
-                                                                             const int32_t maskCount,
-                                                                             const TComp* comps, int32_t count)
+        template <class TComp, class TLayout>
+        inline ComponentsGroup<TComp>* ComponentStorage<TComp, TLayout>::addComponent(GroupIt<TComp> groupIt,
+                                                                                      const TComp* comps, int32_t count)
         {
-            // Check if we have enough space
-            if (size + count >= capacity)
+            // Hold group reference
+            CompGroup<TComp>* group = groupIt->second;
+
+            if (!shared)
             {
-                grow();
+                // Grow the group own pages, no other group is touched
+                if (group->size + count >= group->pages.capacity)
+                {
+                    group->pages.grow(group->size + count);
+                }
+                group->addComponent(comps, count);
+                version++;
+                return group;
             }
 
-            GroupIt<TComp> groupIt = getComponentGroup(masks, maskCount);
-
-            // Make space for the new components
-            GroupIt<TComp> it = groups.end();
-            for (it--; it != groupIt; it--)
+            // Only reserve more slack (rolling the next groups) once the group slack is exhausted
+            const int32_t missing = group->size + count - group->capacity;
+            if (missing > 0)
             {
-                it->second->rollClockwise(count);
-            }
+                // At least doubles the group capacity
+                const int32_t extra = max(missing, group->capacity);
 
-            // Hold group reference
-            CompGroup<TComp>* group = groupIt->second;
+                // Check if we have enough space
+                if (size + extra >= capacity)
+                {
+                    grow(size + extra);
+                }
+
+                // Make space for the new slack
+                GroupIt<TComp> it = groups.end();
+                for (it--; it != groupIt; it--)
+                {
+                    it->second->rollClockwise(extra);
+                }
+
+                // Increase Reserved Size
+                group->capacity += extra;
+                size += extra;
+            }
 
             // Make space for the new components in the group
             group->shiftClockwise(count);
 
             // Add the new components in the group
             group->addComponent(comps, count);
-
-            // Increase Used Size
-            size += count;
+            version++;
 
             return group;
         }
 
-        template <class TComp>
-        inline TComp* ComponentStorage<TComp>::addComponent(const intptr_t* masks, const int32_t maskCount,
-                                                            const TComp& comp)
+        template <class TComp, class TLayout>
+        inline void ComponentStorage<TComp, TLayout>::removeComponents(GroupIt<TComp> groupIt,
+                                                                       const int32_t* entityIds, int32_t count,
+                                                                       const bool ordered)
+        {
+            _ASSERT(groupIt != groups.end());
+            // Remove Components from specific group, freed slots become slack
+            if (ordered)
+            {
+                groupIt->second->remComponent(entityIds, count);
+            }
+            else
+            {
+                groupIt->second->remComponentUnordered(entityIds, count);
+            }
+            version++;
+        }
+
+        template <class TComp, class TLayout>
+        inline void ComponentStorage<TComp, TLayout>::compact()
+        {
+            if (!shared)
+            {
+                for (GroupIt<TComp> it = groups.begin(); it != groups.end(); it++)
+                {
+                    it->second->pages.release(it->second->size);
+                }
+                version++;
+                return;
+            }
+
+            // Roll every group back, right after the previous one
+            int32_t end = 0;
+            for (GroupIt<TComp> it = groups.begin(); it != groups.end(); it++)
+            {
+                CompGroup<TComp>* group = it->second;
+                group->rollCounterClockwise(group->baseOffset - end);
+                group->capacity = group->size;
+                end += group->size;
+            }
+            size = end;
+            version++;
+
+            // Return unused memory
+            pages.release(size);
+            capacity = pages.capacity;
+        }
+
+        template <class TComp, class TLayout>
+        inline TComp* ComponentStorage<TComp, TLayout>::addComponent(const int32_t* types, const int32_t typesCount,
+                                                                     const TComp& comp)
         {
-            ComponentsGroup<TComp>* group = addComponent(masks, maskCount, &comp, 1);
+            ComponentsGroup<TComp>* group = addComponent(types, typesCount, &comp, 1);
 
             // Return Component Reference
             return group->getLastComponent();
         }
 
-        template <class TComp>
-        inline GroupIt<TComp> ComponentStorage<TComp>::getComponentGroup(const intptr_t* masks, const int32_t maskCount)
+        template <class TComp, class TLayout>
+        inline GroupIt<TComp> ComponentStorage<TComp, TLayout>::getComponentGroup(const int32_t* types,
+                                                                                  const int32_t typesCount)
         {
             // Compute Group Mask
-            GroupMask mask(masks, maskCount);
+            GroupMask mask(types, typesCount);
 
             // Get existing group
             GroupIt<TComp> it = groups.lower_bound(mask);
@@ -195,67 +372,90 @@ namespace rv
             // Creates new Group
             it = groups.insert(it, GroupMaskPair<TComp>(mask, nullptr));
             // Proper Initialization
-            int32_t baseOffset = 0;
-            if (it != groups.begin())
+            if (!shared)
             {
-                GroupIt<TComp> lastGroupIt = it;
-                --lastGroupIt;
-                CompGroup<TComp>* lastGroup = lastGroupIt->second;
-                baseOffset = lastGroup->baseOffset + lastGroup->size;
+                // Group owns its pages, always starting at position 0
+                it->second = new CompGroup<TComp>(10);
+            }
+            else
+            {
+                int32_t baseOffset = 0;
+                if (it != groups.begin())
+                {
+                    GroupIt<TComp> lastGroupIt = it;
+                    --lastGroupIt;
+                    CompGroup<TComp>* lastGroup = lastGroupIt->second;
+                    baseOffset = lastGroup->baseOffset + lastGroup->capacity;
+                }
+                it->second = new CompGroup<TComp>(pages, baseOffset);
             }
-            it->second = new CompGroup<TComp>(data, baseOffset);
+            version++;
 
-            // Skip current ComponentType ptr
-            const intptr_t curType = (intptr_t)getInstance();
-            intptr_t* selComb = new intptr_t[maskCount - 1];
-            for (int32_t i = 0, j = 0; i < maskCount - 1; i++, j++)
+            // Append the new group to every query it matches
+            const GroupMaskCmp cmp;
+            for (QueryIt<TComp> queryIt = queries.begin(); queryIt != queries.end(); queryIt++)
             {
-                if (masks[j] == curType)
+                if (!mask.contains(queryIt->first))
                 {
-                    j++;
+                    continue;
                 }
-                selComb[i] = masks[j];
+                QueryGroups<TComp>& queryGroups = queryIt->second;
+                queryGroups.insert(std::upper_bound(queryGroups.begin(), queryGroups.end(), mask,
+                                                    [&cmp](const GroupMask& newMask, const GroupIt<TComp>& groupIt) {
+                                                        return cmp(newMask, groupIt->first);
+                                                    }),
+                                   it);
             }
-            // Insert Group Mask in the registry
-            GroupsRegIt regEntryIt = getRegistryEntryIt(curType);
-            regEntryIt->second.insert(mask);
-            // Insert Group Mask for all combinations
-            int32_t combCount;
-            intptr_t* combs = getMaskCombinations(selComb, maskCount - 1, combCount);
-            for (int32_t i = 0; i < combCount; i++)
+            return it;
+        }
+
+        template <class TComp, class TLayout>
+        inline GroupIt<TComp> ComponentStorage<TComp, TLayout>::getArchetypeGroup(const Archetype* archetype)
+        {
+            if (archetype->id >= (int32_t)archetypeGroups.size())
             {
-                const intptr_t comb = curType + combs[i];
-                regEntryIt = getRegistryEntryIt(comb);
-                regEntryIt->second.insert(mask);
+                archetypeGroups.resize(archetype->id + 1, groups.end());
+            }
+            GroupIt<TComp>& it = archetypeGroups[archetype->id];
+            if (it == groups.end())
+            {
+                it = getComponentGroup(archetype->types, archetype->typesCount);
             }
-            delete[] combs;
-            delete[] selComb;
             return it;
         }
 
-        template <class TComp>
-        inline GroupsRegIt ComponentStorage<TComp>::getRegistryEntryIt(const intptr_t mask)
+        template <class TComp, class TLayout>
+        inline TComp* ComponentStorage<TComp, TLayout>::getComponent(const Archetype* archetype, const int32_t entityId)
         {
-            // Look for registry entry
-            GroupsRegIt regIt = groupsRegistry.lower_bound(mask);
+            return getArchetypeGroup(archetype)->second->getComponent(entityId);
+        }
 
-            // If no registry entry exists
-            if (regIt != groupsRegistry.end() && !(groupsRegistry.key_comp()(mask, regIt->first)))
+        template <class TComp, class TLayout>
+        inline QueryIt<TComp> ComponentStorage<TComp, TLayout>::getQuery(const GroupMask& mask)
+        {
+            // Get existing query
+            QueryIt<TComp> queryIt = queries.lower_bound(mask);
+            if (queryIt != queries.end() && !(queries.key_comp()(mask, queryIt->first)))
             {
-                return regIt;
+                return queryIt;
             }
 
-            // Create a new registry set on the corret position
-            regIt = groupsRegistry.insert(regIt, GroupRegPair(mask, GroupMaskSet()));
-
-            // Returns entry
-            return regIt;
+            // Register the query, matching the groups created so far
+            queryIt = queries.insert(queryIt, typename QueriesMap<TComp>::value_type(mask, QueryGroups<TComp>()));
+            for (GroupIt<TComp> groupIt = groups.begin(); groupIt != groups.end(); groupIt++)
+            {
+                if (groupIt->first.contains(mask))
+                {
+                    queryIt->second.push_back(groupIt);
+                }
+            }
+            return queryIt;
         }
 
-        template <class TComp>
-        inline ComponentStorage<TComp>* ComponentStorage<TComp>::getInstance()
+        template <class TComp, class TLayout>
+        inline ComponentStorage<TComp, TLayout>* ComponentStorage<TComp, TLayout>::getInstance()
         {
-            static ComponentStorage<TComp>* storage = new ComponentStorage<TComp>();
+            static ComponentStorage* storage = new ComponentStorage();
             return storage;
         }
 
@@ -0,0 +1,151 @@
+#ifndef COMPONENTTRAITS_HPP
+#define COMPONENTTRAITS_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+// Whether each group of a component storage owns its own buffer by default
+#ifndef RV_GROUP_STORAGE
+#define RV_GROUP_STORAGE 0
+#endif
+
+// Whether removals keep the order of the remaining entities by default
+#ifndef RV_ORDERED_REMOVAL
+#define RV_ORDERED_REMOVAL 1
+#endif
+
+// Whether component storages are paged by default
+#ifndef RV_PAGED_STORAGE
+#define RV_PAGED_STORAGE 0
+#endif
+
+// Size (in bytes) of each page of a paged component storage
+#ifndef RV_PAGE_SIZE
+#define RV_PAGE_SIZE (16 * 1024)
+#endif
+
+// Whether contiguous component storages reserve virtual memory by default (Linux only)
+#ifndef RV_RESERVED_STORAGE
+#define RV_RESERVED_STORAGE 0
+#endif
+
+// Size (in bytes) of the virtual memory initially reserved by each reserved storage
+#ifndef RV_RESERVE_SIZE
+#define RV_RESERVE_SIZE (size_t(256) << 20)
+#endif
+
+// Amount of consecutive components (a power of two) of a group sharing a single change version
+#ifndef RV_CHANGE_BLOCK
+#define RV_CHANGE_BLOCK 128
+#endif
+
+// Alignment (in bytes, a power of two) of the component arrays, a cache line and an AVX-512 register
+#ifndef RV_COMPONENT_ALIGN
+#define RV_COMPONENT_ALIGN 64
+#endif
+
+// Amount of entities (a power of two, up to 32) the chunks of aligned systems are padded to
+#ifndef RV_CHUNK_LANES
+#define RV_CHUNK_LANES 16
+#endif
+
+namespace rv
+{
+    struct Entity;
+
+    /**
+     * @brief Layout where all groups of a storage share a single array, rolling around each other as they grow.
+     */
+    struct SharedLayout
+    {
+        static constexpr bool shared = true;
+    };
+
+    /**
+     * @brief Layout where each group owns a growable buffer, so it never rolls and is iterated as a single chunk.
+     */
+    struct GroupLayout
+    {
+        static constexpr bool shared = false;
+    };
+
+    /**
+     * @brief Storage options of a component type, specialize it to change the options of a single type.
+     */
+    template <class TComponent>
+    struct ComponentTraits
+    {
+        /**
+         * @brief Default layout of the storage, \see{SharedLayout} or \see{GroupLayout}.
+         */
+        using Layout = typename std::conditional<RV_GROUP_STORAGE, GroupLayout, SharedLayout>::type;
+        /**
+         * @brief Whether archetypes with this type keep their entities in order when some of them are removed.
+         * Archetypes are unordered only if none of their types needs order, they then fill each removed slot with
+         * their last entity in constant time.
+         */
+        static constexpr bool ordered = RV_ORDERED_REMOVAL;
+        /**
+         * @brief Whether components are stored in fixed-size pages, instead of a single array.
+         * Paged storages grow by adding pages, without copying (or moving) the existing ones.
+         */
+        static constexpr bool paged = RV_PAGED_STORAGE;
+        /**
+         * @brief Size (in bytes) of each page, rounded down to a power of two amount of components.
+         */
+        static constexpr int32_t pageBytes = RV_PAGE_SIZE;
+        /**
+         * @brief Whether a contiguous storage reserves a virtual memory range up front, growing in place.
+         * Only available on Linux, other platforms fall back to the heap.
+         */
+        static constexpr bool reserved = RV_RESERVED_STORAGE;
+        /**
+         * @brief Size (in bytes) of the reserved range, it is remapped (without copies) if exhausted.
+         */
+        static constexpr size_t reserveBytes = RV_RESERVE_SIZE;
+    };
+
+    /**
+     * @brief Entities are found through the \see{EntitiesTable}, so they never need their archetypes ordered.
+     */
+    template <>
+    struct ComponentTraits<Entity> : ComponentTraits<void>
+    {
+        static constexpr bool ordered = false;
+    };
+
+    /**
+     * @brief How a system accesses a component type, `const T` only reads the components of type T.
+     */
+    template <class TComponent>
+    struct ComponentAccess
+    {
+        /**
+         * @brief Stored component type, const types share the storage of the mutable one.
+         */
+        using Type = typename std::remove_const<TComponent>::type;
+        /**
+         * @brief Whether the components are only read, entity handles are never written by systems.
+         */
+        static constexpr bool readOnly = std::is_const<TComponent>::value || std::is_same<Type, Entity>::value;
+        /**
+         * @brief Whether archetypes lacking the type still match, \see{Optional}.
+         */
+        static constexpr bool optional = false;
+        /**
+         * @brief Whether chunks are skipped unless changed since the system last ran, \see{Changed}.
+         */
+        static constexpr bool changed = false;
+        using Pointer = TComponent*;
+    };
+
+    template <class TComponent>
+    using ComponentType = typename ComponentAccess<TComponent>::Type;
+
+    template <class TComponent>
+    using ComponentPointer = typename ComponentAccess<TComponent>::Pointer;
+
+} // namespace rv
+
+#endif
\ No newline at end of file
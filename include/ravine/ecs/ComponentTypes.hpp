@@ -0,0 +1,76 @@
+#ifndef COMPONENTTYPES_HPP
+#define COMPONENTTYPES_HPP
+
+#include <atomic>
+#include <stdint.h>
+
+#include "ComponentTraits.hpp"
+
+// Maximum amount of component types, defines the width of every group mask
+#ifndef RV_MAX_COMPONENTS
+#define RV_MAX_COMPONENTS 256
+#endif
+
+namespace rv
+{
+    class IComponentStorage;
+
+    /**
+     * @brief Registry of component types, each one receives a dense id the first time it is used.
+     */
+    class ComponentTypes
+    {
+      private:
+        // Types may be first used from many threads at once (e.g. recording commands)
+        inline static std::atomic<int32_t>& counter()
+        {
+            static std::atomic<int32_t> typesCount(0);
+            return typesCount;
+        }
+
+        inline static int32_t registerType(const bool isOrdered)
+        {
+            const int32_t typeId = counter()++;
+            _ASSERT(typeId < RV_MAX_COMPONENTS);
+            ordered(typeId) = isOrdered;
+            return typeId;
+        }
+
+      public:
+        /**
+         * @brief Returns the dense id of a component type, in the range [0, RV_MAX_COMPONENTS).
+         */
+        template <class TComponent>
+        inline static int32_t id()
+        {
+            static const int32_t typeId = registerType(ComponentTraits<TComponent>::ordered);
+            return typeId;
+        }
+
+        /**
+         * @brief Amount of component types registered so far.
+         */
+        inline static int32_t count() { return counter(); }
+
+        /**
+         * @brief Storage of each registered component type, indexed by type id.
+         */
+        inline static IComponentStorage*& storage(const int32_t typeId)
+        {
+            static IComponentStorage* storages[RV_MAX_COMPONENTS] = {};
+            return storages[typeId];
+        }
+
+        /**
+         * @brief Whether each registered type needs the order of its archetypes kept, indexed by type id.
+         */
+        inline static bool& ordered(const int32_t typeId)
+        {
+            static bool orderedTypes[RV_MAX_COMPONENTS] = {};
+            return orderedTypes[typeId];
+        }
+    };
+
+} // namespace rv
+
+#endif
\ No newline at end of file
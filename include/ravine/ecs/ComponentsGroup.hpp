@@ -3,7 +3,11 @@
 
 #include <cstdlib>
 #include <string>
+#include <vector>
 
+#include "ChangeTracking.hpp"
+#include "ComponentPages.hpp"
+#include "EntitiesTable.hpp"
 #include "Entity.hpp"
 #include "FastMath.h"
 
@@ -12,16 +16,41 @@ namespace rv
     template <class TComponent>
     struct ComponentsGroup
     {
-        TComponent* const& data;
+        ComponentPages<TComponent>& pages;
         int32_t baseOffset = 0;
         int32_t size = 0;
         int32_t tipOffset = 0;
+        /**
+         * @brief Slots reserved by the group (its size plus slack), the next group starts right after them.
+         */
+        int32_t capacity = 0;
+        /**
+         * @brief Version of the last write of each block of RV_CHANGE_BLOCK components, indexed by id.
+         */
+        std::vector<uint32_t> changes;
+        /**
+         * @brief Pages owned by the group (group layout), nullptr if they are the storage ones.
+         */
+        ComponentPages<TComponent>* ownedPages = nullptr;
 
-        constexpr ComponentsGroup(TComponent* const& storageData, const int32_t storageOffset)
-            : data(storageData), baseOffset(storageOffset)
+        inline ComponentsGroup(ComponentPages<TComponent>& storagePages, const int32_t storageOffset)
+            : pages(storagePages), baseOffset(storageOffset)
         {
         }
 
+        /**
+         * @brief Creates a group with its own pages, always starting at position 0.
+         */
+        inline explicit ComponentsGroup(const int32_t minCapacity)
+            : pages(*new ComponentPages<TComponent>(minCapacity)), ownedPages(&pages)
+        {
+        }
+
+        ComponentsGroup(const ComponentsGroup&) = delete;
+        ComponentsGroup& operator=(const ComponentsGroup&) = delete;
+
+        ~ComponentsGroup() { delete ownedPages; }
+
         inline void addComponent(const TComponent* comps, const uint32_t count);
 
         inline void addComponent(const TComponent& comp);
@@ -37,6 +66,15 @@ namespace rv
 
         inline void remComponent(const int32_t compId);
 
+        /**
+         * @brief Removes the given components by moving the last ones into their slots, order is not kept.
+         * Constant time per component, once the group is unrolled (only needed after it was rolled around).
+         *
+         * @param compIds Sorted list (ascending) of Ids whose components will be removed.
+         * @param count Size of the given component Ids list.
+         */
+        inline void remComponentUnordered(const int32_t* compIds, const int32_t count);
+
         inline TComponent* getComponent(const int32_t compId);
 
         /**
@@ -72,11 +110,34 @@ namespace rv
         inline int32_t shiftClockwise(int32_t count);
 
         /**
-         * @brief Usefull shortcut for accessing group start ptr.
+         * @brief Rolls the components back in place, so the tipOffset is 0.
+         * Doesn't move base ptr, component ids are maintained.
+         */
+        inline void unroll();
+
+        /**
+         * @brief Usefull shortcut for accessing group start position.
+         *
+         * @return int32_t Group start position in the storage pages.
+         */
+        inline int32_t dataPos() const;
+
+        /**
+         * @brief Updates the bookkeeping of components whose id changed (e.g. entity locations).
          *
-         * @return TComponent* Group start data position ptr.
+         * @param compId First component id that changed.
+         * @param count Amount of consecutive components that changed.
          */
-        inline TComponent* dataPos();
+        inline void relocate(const int32_t compId, const int32_t count);
+
+        /**
+         * @brief Stamps the blocks of the given components as written at the given version.
+         *
+         * @param compId First component id that was written.
+         * @param count Amount of consecutive components that were written.
+         */
+        inline void markChanged(const int32_t compId, const int32_t count,
+                                uint32_t version = ChangeTracking::pending());
 
         // TODO: Implement Shift CounterClockwise
         // TODO: Implement Swap of Components
@@ -91,32 +152,12 @@ namespace rv
         const int32_t rightCount = rightMask * -missLeft;
         const int32_t leftCount = rightMask * tipOffset + (1 - rightMask) * count;
         // Add components at group end
-        memcpy(dataPos() + size, comps + 0, rightCount * sizeof(TComponent));
+        pages.write(dataPos() + size, comps + 0, rightCount);
         // Add components before tip
-        memcpy(dataPos() + tipOffset - leftCount, comps + rightCount, leftCount * sizeof(TComponent));
-        size += rightCount;
-    }
-
-    template <>
-    inline void ComponentsGroup<Entity>::addComponent(const Entity* comps, const uint32_t count)
-    {
-        const int32_t missLeft = tipOffset - count;
-        const int32_t rightMask = signMask(missLeft);
-        const int32_t rightCount = rightMask * -missLeft;
-        const int32_t leftCount = rightMask * tipOffset + (1 - rightMask) * count;
-        Entity* dst = dataPos() + size;
-        memcpy(dst, comps + 0, rightCount * sizeof(Entity)); // Copy to the end of the group
-        for (int32_t i = 0; i < rightCount; i++)             // Update Entity IDs
-        {
-            dst[i].id = size + i;
-        }
-        dst = dataPos() + tipOffset - leftCount;
-        memcpy(dst, comps + rightCount, leftCount * sizeof(Entity)); // Copy components to the left of the tip
-        for (int32_t i = 0; i < leftCount; i++)                      // Update Entity IDs
-        {
-            dst[i].id = size - leftCount + rightCount + i;
-        }
+        pages.write(dataPos() + tipOffset - leftCount, comps + rightCount, leftCount);
         size += rightCount;
+        // Components are always added at the end of the group
+        relocate(size - count, count);
     }
 
     template <class TComponent>
@@ -166,7 +207,7 @@ namespace rv
             // Perform compression by moving memory blocks
             const int32_t srcPos = actualPos + 1;
             const int32_t dstPos = srcPos - comprShifts;
-            memmove(dataPos() + dstPos, dataPos() + srcPos, comprCount * sizeof(TComponent));
+            pages.move(dataPos() + dstPos, dataPos() + srcPos, comprCount);
         }
         size -= leftComprCount;
 
@@ -191,7 +232,7 @@ namespace rv
             const int32_t comprCount = comprPos - rightSize;
 
             // Perform compression by moving memory blocks
-            memmove(dataPos() + comprShifts, dataPos(), comprCount * sizeof(TComponent));
+            pages.move(dataPos() + comprShifts, dataPos(), comprCount);
         }
         baseOffset += rightComprCount;
         tipOffset -= rightComprCount;
@@ -200,100 +241,45 @@ namespace rv
         // Roll counter-clockwise to fill removed spaces
         rollCounterClockwise(rightComprCount);
 
+        // Every component after the first removed one has a new id
+        relocate(compIds[0], size - compIds[0]);
+
         return leftComprCount;
     }
 
-    template <>
-    inline int32_t ComponentsGroup<Entity>::remComponent(const int32_t* compIds, const int32_t count)
+    template <class TComponent>
+    inline void ComponentsGroup<TComponent>::remComponent(const int32_t compId)
     {
-        const int32_t rightSize = size - tipOffset;
-        int32_t leftComprCount = 0;
+        remComponent(&compId, 1);
+    }
 
-        // Count the number of left compressions
-        for (int32_t i = 0; i < count; i++)
+    template <class TComponent>
+    inline void ComponentsGroup<TComponent>::remComponentUnordered(const int32_t* compIds, const int32_t count)
+    {
+        // Last components must be right before the end of the group
+        if (tipOffset != 0)
         {
-            leftComprCount += signMask(compIds[i] - rightSize);
+            unroll();
         }
 
-        // Count the number of right compressions
-        int32_t rightComprCount = count - leftComprCount;
-
-        // Compress left all elements right of the tip
-        for (int32_t i = leftComprCount - 1; i >= 0; i--)
+        // Fill from the last removed slot, so moved components are never removed afterwards
+        for (int32_t i = count - 1; i >= 0; i--)
         {
-            const int32_t cId = i;
-            const int32_t comprPos = compIds[cId];
-            // Calculate compression shifts
-            int32_t comprShifts = 1;
-            for (int32_t j = cId - 1; j >= 0; j--)
+            const int32_t compId = compIds[i];
+            size--;
+            if (compId != size)
             {
-                const int32_t nextComprPos = compIds[cId - comprShifts];
-                const int32_t fetchLimit = comprPos - comprShifts - 1;
-                const int32_t incMask = signMask(fetchLimit - nextComprPos);
-                comprShifts += incMask; // Increase shift count
-                i -= incMask;           // Can skip next compression
-            }
-            // Actual position of the component without wrapping
-            const int32_t actualPos = tipOffset + comprPos;
-            // Calculate amount of elements to be compressed left
-            const int32_t comprCount = size - actualPos - 1;
-            // Perform compression by moving memory blocks
-            const int32_t srcPos = actualPos + 1;
-            const int32_t dstPos = srcPos - comprShifts;
-            memmove(dataPos() + dstPos, dataPos() + srcPos, comprCount * sizeof(Entity));
-            // Update entity ids
-            for (int32_t i = 0; i < comprCount; i++)
-            {
-                data[baseOffset + dstPos + i].id -= comprShifts;
+                pages.move(dataPos() + compId, dataPos() + size, 1);
+                relocate(compId, 1);
             }
         }
-        size -= leftComprCount;
-
-        // Compress right all elements left of the tip
-        for (int32_t i = leftComprCount; i < count; i++)
-        {
-            const int32_t cId = i;
-            const int32_t comprPos = compIds[cId];
-            // Calculate compression shifts
-            int32_t comprShifts = 1;
-            for (int32_t j = cId + 1; j < count; j++)
-            {
-                const int32_t nextComprPos = compIds[cId + comprShifts];
-                const int32_t fetchLimit = comprPos + comprShifts + 1;
-                const int32_t incMask = signMask(nextComprPos - fetchLimit);
-                comprShifts += incMask; // Increase shift count
-                i += incMask;           // Can skip next compression
-            }
-            // Calculate amount of elements to be compressed right
-            const int32_t comprCount = comprPos - rightSize;
-            // Perform compression by moving memory blocks
-            memmove(dataPos() + comprShifts, dataPos(), comprCount * sizeof(Entity));
-            // Update entity ids
-            for (int32_t i = 0; i < comprCount; i++)
-            {
-                data[baseOffset + comprShifts + i].id -= (comprShifts + leftComprCount);
-            }
-        }
-        baseOffset += rightComprCount;
-        tipOffset -= rightComprCount;
-        size -= rightComprCount;
-
-        // Roll counter-clockwise to fill removed spaces
-        rollCounterClockwise(rightComprCount);
-
-        return leftComprCount;
-    }
-
-    template <class TComponent>
-    inline void ComponentsGroup<TComponent>::remComponent(const int32_t compId)
-    {
-        remComponent(&compId, 1);
     }
 
     template <class TComponent>
     inline TComponent* ComponentsGroup<TComponent>::getComponent(const int32_t compId)
     {
-        return dataPos() + (tipOffset + compId) % size;
+        const int32_t pos = tipOffset + compId;
+        return pages.at(dataPos() + pos - (1 - signMask(pos - size)) * size); // Wrap around
     }
 
     template <class TComponent>
@@ -307,9 +293,9 @@ namespace rv
     {
         const int32_t toCopy = min(size, count);
         const int32_t stride = max(size, count);
-        memcpy(dataPos() + stride, dataPos(), toCopy * sizeof(TComponent)); // Roll data
-        tipOffset -= toCopy;                                                // Decrease tipOffset
-        tipOffset += signMask(tipOffset) * size;                            // Wrap around
+        pages.move(dataPos() + stride, dataPos(), toCopy); // Roll data
+        tipOffset -= toCopy;                               // Decrease tipOffset
+        tipOffset += signMask(tipOffset) * size;           // Wrap around
 
         // Should Increase base ptr
         baseOffset += count;
@@ -321,12 +307,12 @@ namespace rv
         const int32_t dstOffset = min(baseOffset, count);
         const int32_t toCopy = min(dstOffset, size);
         const int32_t srcPos = size - toCopy;
-        TComponent* dst = dataPos() - dstOffset;
-        TComponent* src = dataPos() + srcPos;
-        memcpy(dst, src, toCopy * sizeof(TComponent));      // Roll data
+        const int32_t dst = dataPos() - dstOffset;
+        const int32_t src = dataPos() + srcPos;
+        pages.move(dst, src, toCopy);                       // Roll data
         tipOffset += toCopy;                                // Increase tipOffset
         tipOffset -= signMask(size - tipOffset - 1) * size; // Wrap around
-        baseOffset -= toCopy;                               // Decrease base ptr
+        baseOffset -= dstOffset;                            // Decrease base ptr
     }
 
     template <class TComponent>
@@ -336,58 +322,76 @@ namespace rv
         const int32_t mask = signMask(count - tipOffset - 1);
         const int32_t shiftCount = (tipOffset - count) * mask;
         const int32_t rollCount = count * mask;
-        memcpy(dataPos() + size, dataPos(), rollCount * sizeof(TComponent));       // Roll data
-        memcpy(dataPos(), dataPos() + rollCount, shiftCount * sizeof(TComponent)); // Shift data
+        pages.move(dataPos() + size, dataPos(), rollCount);       // Roll data
+        pages.move(dataPos(), dataPos() + rollCount, shiftCount); // Shift data (may overlap)
         size += count; // Increases size to update end of array
         return count;  // Returns how many slots left before tip
     }
 
     template <class TComponent>
-    TComponent* ComponentsGroup<TComponent>::dataPos()
+    inline void ComponentsGroup<TComponent>::unroll()
     {
-        return data + baseOffset;
+        // Hold the smaller side aside, while the bigger one is moved into place
+        const int32_t rightSize = size - tipOffset;
+        const int32_t heldCount = min(tipOffset, rightSize);
+        TComponent* held = (TComponent*)malloc(heldCount * sizeof(TComponent));
+        if (tipOffset <= rightSize)
+        {
+            pages.read(held, dataPos(), tipOffset);
+            pages.move(dataPos(), dataPos() + tipOffset, rightSize);
+            pages.write(dataPos() + rightSize, held, tipOffset);
+        }
+        else
+        {
+            pages.read(held, dataPos() + tipOffset, rightSize);
+            pages.move(dataPos() + rightSize, dataPos(), tipOffset);
+            pages.write(dataPos(), held, rightSize);
+        }
+        free(held);
+        tipOffset = 0;
     }
 
-    /**
-     * @brief Struct that represents the hash of component types.
-     */
-    struct GroupMask
+    template <class TComponent>
+    inline void ComponentsGroup<TComponent>::relocate(const int32_t compId, const int32_t count)
     {
-        /**
-         * @brief Hash of all pointer types this mask represents.
-         */
-        intptr_t typePtr;
-        /**
-         * @brief Amount of types this mask represents.
-         */
-        int32_t typesCount;
+        markChanged(compId, count);
+    }
 
-        inline GroupMask(const intptr_t* masks, const int32_t count) : typePtr(0), typesCount(count)
+    template <>
+    inline void ComponentsGroup<Entity>::relocate(const int32_t compId, const int32_t count)
+    {
+        EntitiesTable* table = EntitiesTable::getInstance();
+        for (int32_t i = compId; i < compId + count; i++)
         {
-            for (size_t i = 0; i < typesCount; i++)
-            {
-                typePtr += masks[i];
-            }
+            (*table)[getComponent(i)->id].row = i;
         }
-    };
+        markChanged(compId, count);
+    }
 
-    /**
-     * @brief Group Mask Compare operation.
-     */
-    struct GroupMaskCmp
+    template <class TComponent>
+    inline void ComponentsGroup<TComponent>::markChanged(const int32_t compId, const int32_t count,
+                                                         const uint32_t version)
     {
-        inline bool operator()(const GroupMask& a, const GroupMask& b) const
+        if (count <= 0)
         {
-            if (a.typesCount != b.typesCount)
-            {
-                return a.typesCount > b.typesCount;
-            }
-            else
-            {
-                return a.typePtr < b.typePtr;
-            }
+            return;
         }
-    };
+        const int32_t lastBlock = (compId + count - 1) >> ChangeTracking::blockShift;
+        if (lastBlock >= (int32_t)changes.size())
+        {
+            changes.resize(lastBlock + 1, version);
+        }
+        for (int32_t block = compId >> ChangeTracking::blockShift; block <= lastBlock; block++)
+        {
+            changes[block] = version;
+        }
+    }
+
+    template <class TComponent>
+    inline int32_t ComponentsGroup<TComponent>::dataPos() const
+    {
+        return baseOffset;
+    }
 
 } // namespace rv
 
@@ -8,50 +8,153 @@ namespace rv
     template <typename TComp> struct CompIt
     {
       private:
-        TComp* data;
+        using Pages = ComponentPages<TComp>;
+
+        TComp* const* pages;
+        int32_t base;
         int32_t lSize;
         int32_t rSize;
+        // Change version of each block of the group
+        uint32_t* changes;
 
       public:
-        constexpr CompIt() : data(nullptr), lSize(0), rSize(0) {}
-        constexpr CompIt(TComp* data, int32_t offset, int32_t size) : data(data), lSize(offset), rSize(size - offset) {}
+        constexpr CompIt() : pages(nullptr), base(0), lSize(0), rSize(0), changes(nullptr) {}
+        constexpr CompIt(TComp* const* pages, int32_t base, int32_t offset, int32_t size, uint32_t* changes)
+            : pages(pages), base(base), lSize(offset), rSize(size - offset), changes(changes)
+        {
+        }
         inline ~CompIt() {}
 
         constexpr int32_t getSize() const { return lSize + rSize; }
 
+        /**
+         * @brief Returns the contiguous run of components starting at the given id.
+         * Runs are split at the tip of the group and at page boundaries, iterators of missing groups return
+         * nullptr without limiting the run.
+         */
         TComp* const getChunk(int32_t id, int32_t& size)
         {
+            if (pages == nullptr)
+            {
+                size = INT32_MAX;
+                return nullptr;
+            }
+            int32_t pos;
             if (id < rSize)
             {
-                size = rSize;
-                return &data[lSize + id];
+                size = rSize - id;
+                pos = base + lSize + id;
             }
             else // (id >= rSize)
             {
-                size = lSize;
-                return &data[id - rSize];
+                size = lSize - (id - rSize);
+                pos = base + id - rSize;
+            }
+            size = min(size, Pages::pageRun(pos));
+            return pages[pos >> Pages::pageShift] + (pos & Pages::pageMask);
+        }
+
+        /**
+         * @brief Stamps the blocks of the run [id, id + size) as written at the given version.
+         */
+        inline void markChanged(const int32_t id, const int32_t size, const uint32_t version)
+        {
+            if (changes == nullptr)
+            {
+                return;
+            }
+            const int32_t lastBlock = (id + size - 1) >> ChangeTracking::blockShift;
+            for (int32_t block = id >> ChangeTracking::blockShift; block <= lastBlock; block++)
+            {
+                changes[block] = version;
             }
         }
+
+        /**
+         * @brief Whether any block of the run [id, id + size) was written after the given version.
+         */
+        inline bool changedSince(const int32_t id, const int32_t size, const uint32_t version) const
+        {
+            if (changes == nullptr)
+            {
+                return false;
+            }
+            const int32_t lastBlock = (id + size - 1) >> ChangeTracking::blockShift;
+            for (int32_t block = id >> ChangeTracking::blockShift; block <= lastBlock; block++)
+            {
+                // Versions may wrap around, so compare their distance
+                if ((int32_t)(changes[block] - version) > 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
     };
 
     template <typename TComp> struct CompGroupIt
     {
-        // Iterator Group Fields
-        CompIt<TComp> compIt[50];
-        // Current Group Iterator
-        uint8_t count;
+        /**
+         * @brief Amount of group iterators stored inline, bigger queries spill to a heap array.
+         */
+        static constexpr int32_t inlineCapacity = 8;
+
+        // Iterator Group Fields (inline or heap array)
+        CompIt<TComp>* compIt;
+        // Amount of Group Iterators
+        int32_t count;
 
-        constexpr CompGroupIt() : count(0) {}
+      private:
+        int32_t capacity;
+        CompIt<TComp> inlineIt[inlineCapacity];
+
+      public:
+        inline CompGroupIt() : compIt(inlineIt), count(0), capacity(inlineCapacity) {}
 
-        inline CompGroupIt(ComponentsGroup<TComp>** groups, const int32_t groupCount, TComp* data) : count(groupCount)
+        // Iterators are rebuilt in place, never copied around
+        CompGroupIt(const CompGroupIt&) = delete;
+        CompGroupIt& operator=(const CompGroupIt&) = delete;
+
+        ~CompGroupIt()
         {
-            for (uint8_t i = 0; i < count; i++)
+            if (compIt != inlineIt)
             {
-                const ComponentsGroup<TComp>* group = groups[i];
-                compIt[i] = CompIt<TComp>(group->data + group->baseOffset, group->tipOffset, group->size);
+                delete[] compIt;
             }
+            count = -1;
         }
-        ~CompGroupIt() { count = -1; }
+
+        /**
+         * @brief Clears the iterator and makes room for the given amount of groups.
+         * The heap array (if any) is kept for later rebuilds, it only grows.
+         *
+         * @param groupCount Amount of groups that will be pushed.
+         */
+        inline void reset(const int32_t groupCount)
+        {
+            count = 0;
+            if (groupCount <= capacity)
+            {
+                return;
+            }
+            if (compIt != inlineIt)
+            {
+                delete[] compIt;
+            }
+            compIt = new CompIt<TComp>[groupCount];
+            capacity = groupCount;
+        }
+
+        inline void push(ComponentsGroup<TComp>* group)
+        {
+            compIt[count++] = CompIt<TComp>(group->pages.pages, group->baseOffset, group->tipOffset, group->size,
+                                            group->changes.data());
+        }
+
+        /**
+         * @brief Pushes the iterator of a group the storage lacks (e.g. an optional type).
+         */
+        inline void pushEmpty() { compIt[count++] = CompIt<TComp>(); }
     };
 } // namespace rv
 
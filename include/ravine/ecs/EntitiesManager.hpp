@@ -1,140 +1,920 @@
 #ifndef ENTITIESMANAGER_HPP
 #define ENTITIESMANAGER_HPP
 
+#include <algorithm>
+
+#include "Archetype.hpp"
 #include "ComponentStorage.hpp"
+#include "EntitiesTable.hpp"
 #include "Entity.hpp"
+#include "TemplateIndexPack.h"
 #include "TemplateMaskPack.h"
 
+using std::get;
 using std::tuple;
 
 namespace rv
 {
+    using ArchetypesMap = std::map<GroupMask, Archetype*, GroupMaskCmp>;
 
     class EntitiesManager
     {
-        template <class... TComponents>
-        friend class BaseSystem;
+        template <class TKernel, class TComponents, class TFilters>
+        friend class QuerySystem;
 
       private:
         template <class... TComponents>
-        constexpr static intptr_t getTypeMask();
+        inline static const GroupMask& getTypeMask();
+
+        template <class... TComponents>
+        inline static const MaskArray<sizeof...(TComponents)>& getMaskArray();
+
+        inline static ArchetypesMap& getArchetypes();
+
+        inline static Archetype* getArchetype(const int32_t* types, int32_t typesCount);
 
         template <class... TComponents>
-        constexpr static MaskArray<sizeof...(TComponents)> getMaskArray();
+        inline static Archetype* getArchetype();
+
+        /**
+         * @brief Returns the archetype reached by adding (or removing) a type, cached in the archetypes graph.
+         *
+         * @param archetype Source archetype.
+         * @param type Component type id being added or removed.
+         * @param add Whether the type is being added or removed.
+         * @return Archetype* Destination archetype, the source one if it already has (or lacks) the type.
+         */
+        inline static Archetype* getTransition(Archetype* archetype, int32_t type, bool add);
+
+        /**
+         * @brief Moves entities between archetypes, through every storage of the source archetype.
+         *
+         * @param ids Sorted list (ascending) of entity ids, all from the source archetype.
+         * @param count Size of the given entity ids list.
+         */
+        inline static void moveEntities(Archetype* oldArchetype, Archetype* newArchetype, const int32_t* ids,
+                                        int32_t count);
+
+        /**
+         * @brief Adds (or removes) a component to many entities, migrating each source archetype in a single pass.
+         *
+         * @param values Values of the added components, nullptr when removing.
+         * @param valuesStride 1 if each entity has its own value, 0 if they all share the first one.
+         */
+        template <class TComponent, bool TAdd>
+        inline static void migrateEntities(const Entity* entities, int32_t count, const TComponent* values,
+                                           int32_t valuesStride);
 
         template <class TComponent>
-        inline static CompGroupIt<TComponent> getComponentIterator(intptr_t mask);
+        inline static void getComponentIterator(const GroupMask& mask, CompGroupIt<TComponent>& it);
 
         template <class... TComponents>
-        inline static tuple<CompGroupIt<TComponents>...> getComponentIterators();
+        inline static void getComponentIterators(tuple<CompGroupIt<TComponents>...>& its);
+
+        template <class... TComponents, class TFunction, int... S>
+        inline static void forEachChunkUnfold(TFunction& function, seq<S...>);
 
-        template <class TComponent, class... TComponents>
-        inline static TComponent* createComponent(MaskArray<sizeof...(TComponents)> maskArray,
-                                                  const TComponent& arg = TComponent());
+        template <class TComponent>
+        inline static TComponent* createComponent(const Archetype* archetype, const TComponent& arg = TComponent());
+
+        template <class TComponent>
+        inline static ComponentsGroup<TComponent>* createComponents(const Archetype* archetype,
+                                                                    const TComponent* args, int32_t count);
 
         template <class... TComponents>
-        inline static Entity* createComponents(TComponents... args);
+        inline static Entity createComponents(TComponents... args);
 
         template <class... TComponents>
-        inline static Entity* createComponents();
+        inline static Entity createComponents();
+
+        /**
+         * @brief Records entities that gained (or lost) every type of an archetype, for the types with events.
+         */
+        inline static void recordEvents(const Archetype* archetype, const Entity* entities, int32_t count,
+                                        bool added);
 
       public:
+        /**
+         * @brief Checks whether the handle still refers to a live entity.
+         */
+        inline static bool isValid(const Entity& entity);
+
+        /**
+         * @brief Returns the component of an entity, in constant time.
+         * Mutable components are marked changed, ask for `const TComponent` to only read them.
+         *
+         * @param entity Entity handle, must be valid and have the component.
+         * @return TComponent* The component, valid until the next structural change.
+         */
+        template <class TComponent>
+        inline static TComponent* get(Entity entity);
+
+        /**
+         * @brief Returns the component of an entity, in constant time.
+         * Mutable components are marked changed, ask for `const TComponent` to only read them.
+         *
+         * @param entity Entity handle.
+         * @return TComponent* The component, or nullptr if the handle is stale or the entity lacks the component.
+         */
+        template <class TComponent>
+        inline static TComponent* tryGet(Entity entity);
+
+        /**
+         * @brief Copies the components of many entities, gathered in memory order to stay cache-friendly.
+         *
+         * @param entities List of entity handles, must be valid and have the component.
+         * @param count Size of the given entities list.
+         * @param out Output list of components, in the same order as the entities.
+         */
+        template <class TComponent>
+        inline static void get(const Entity* entities, int32_t count, TComponent* out);
+
         template <class... TComponents>
         inline static Entity createEntity(TComponents... args);
 
         template <class... TComponents>
         inline static Entity createEntity();
 
+        /**
+         * @brief Creates many entities with the same component types in a single structural change per storage.
+         *
+         * @param count Amount of entities to be created.
+         * @return Entity* Buffer with the created entities (owned by the caller, release with delete[]).
+         */
+        template <class... TComponents>
+        inline static Entity* createEntities(int32_t count);
+
+        /**
+         * @brief Creates many entities with the same component types in a single structural change per storage.
+         *
+         * @param count Amount of entities to be created.
+         * @param values Initial value of each component type, shared by all the created entities.
+         * @return Entity* Buffer with the created entities (owned by the caller, release with delete[]).
+         */
         template <class... TComponents>
-        inline static void removeEntity(Entity& entity);
+        inline static Entity* createEntities(int32_t count, const TComponents&... values);
+
+        /**
+         * @brief Creates many entities with the same component types in a single structural change per storage.
+         *
+         * @param count Amount of entities to be created.
+         * @param values Initial values of each component type, one array of 'count' elements per type.
+         * @return Entity* Buffer with the created entities (owned by the caller, release with delete[]).
+         */
+        template <class... TComponents>
+        inline static Entity* createEntities(int32_t count, const TComponents*... values);
+
+        /**
+         * @brief Adds a component to a live entity, moving it to the archetype with the new type.
+         * If the entity already has the component, its value is overwritten instead.
+         *
+         * @param entity Entity to be migrated, invalid handles are ignored.
+         * @param value Value of the new component.
+         */
+        template <class TComponent>
+        inline static void addComponent(Entity entity, const TComponent& value = TComponent());
+
+        /**
+         * @brief Removes a component from a live entity, moving it to the archetype without that type.
+         *
+         * @param entity Entity to be migrated, invalid handles are ignored.
+         */
+        template <class TComponent>
+        inline static void removeComponent(Entity entity);
+
+        /**
+         * @brief Adds a component to many live entities, migrating each source archetype in a single pass.
+         *
+         * @param entities List of distinct entities to be migrated, invalid handles are ignored.
+         * @param count Size of the given entities list.
+         * @param value Value of the new components.
+         */
+        template <class TComponent>
+        inline static void addComponents(const Entity* entities, int32_t count,
+                                         const TComponent& value = TComponent());
+
+        /**
+         * @brief Same as \see{addComponents}, but each entity gets its own value.
+         *
+         * @param values Value of the new component of each entity, in the same order as the entities.
+         */
+        template <class TComponent>
+        inline static void addComponents(const Entity* entities, int32_t count, const TComponent* values);
+
+        /**
+         * @brief Removes a component from many live entities, migrating each source archetype in a single pass.
+         *
+         * @param entities List of distinct entities to be migrated, invalid handles are ignored.
+         * @param count Size of the given entities list.
+         */
+        template <class TComponent>
+        inline static void removeComponents(const Entity* entities, int32_t count);
+
+        /**
+         * @brief Removes an entity and all its components.
+         *
+         * @param entity Entity to be removed.
+         * @return bool False if the handle was stale (nothing is removed).
+         */
+        inline static bool removeEntity(Entity entity);
+
+        /**
+         * @brief Removes many entities and all their components, in a single pass per archetype and storage.
+         *
+         * @param entities List of entities to be removed, stale (or repeated) handles are ignored.
+         * @param count Size of the given entities list.
+         * @return int32_t Amount of entities actually removed.
+         */
+        inline static int32_t destroyEntities(const Entity* entities, int32_t count);
+
+        /**
+         * @brief Calls the function with the components of every contiguous run of entities having all the given
+         * types, walking the cached query of each storage. Types may be const to only read them, the groups of the
+         * mutable ones are marked changed. The function must not make structural changes (defer them instead).
+         *
+         * @param function Called as `function(int32_t count, TComponents*... components)`.
+         */
+        template <class... TComponents, class TFunction>
+        inline static void forEachChunk(TFunction&& function);
+
+        /**
+         * @brief Same as \see{forEachChunk}, but calls the function once per entity.
+         *
+         * @param function Called as `function(TComponents&... components)`.
+         */
+        template <class... TComponents, class TFunction>
+        inline static void each(TFunction&& function);
+
+        /**
+         * @brief Returns the events of a component type, recording them from now on.
+         */
+        template <class TComponent>
+        inline static const ComponentEvents& getEvents();
+
+        /**
+         * @brief Frame sync point, publishes the events recorded since the last sync.
+         * Called by \see{SystemManager} before running the systems.
+         */
+        inline static void syncEvents();
+
+        /**
+         * @brief Returns the slack groups keep after removals, packing every storage.
+         * Growing a compacted group rolls all the groups after it again.
+         */
+        inline static void compact();
     };
 
     template <class... TComponents>
-    constexpr intptr_t EntitiesManager::getTypeMask()
+    inline const GroupMask& EntitiesManager::getTypeMask()
     {
         return MaskPack<TComponents...>::mask();
     }
 
     template <class... TComponents>
-    constexpr MaskArray<sizeof...(TComponents)> EntitiesManager::getMaskArray()
+    inline const MaskArray<sizeof...(TComponents)>& EntitiesManager::getMaskArray()
+    {
+        return MaskPack<TComponents...>::types();
+    }
+
+    inline ArchetypesMap& EntitiesManager::getArchetypes()
+    {
+        static ArchetypesMap archetypes;
+        return archetypes;
+    }
+
+    inline Archetype* EntitiesManager::getArchetype(const int32_t* types, const int32_t typesCount)
+    {
+        ArchetypesMap& archetypes = getArchetypes();
+        GroupMask mask(types, typesCount);
+
+        // Get existing archetype
+        ArchetypesMap::iterator it = archetypes.lower_bound(mask);
+        if (it != archetypes.end() && !(archetypes.key_comp()(mask, it->first)))
+        {
+            return it->second;
+        }
+
+        // Creates new Archetype
+        Archetype* archetype = new Archetype((int32_t)archetypes.size(), types, typesCount);
+        archetypes.insert(it, ArchetypesMap::value_type(mask, archetype));
+        return archetype;
+    }
+
+    template <class... TComponents>
+    inline Archetype* EntitiesManager::getArchetype()
     {
-        return {reinterpret_cast<intptr_t>(ComponentStorage<TComponents>::getInstance())...};
+        // Shared by all entities with the same component types
+        static Archetype* archetype = getArchetype(getMaskArray<TComponents...>().data(), sizeof...(TComponents));
+        return archetype;
+    }
+
+    inline Archetype* EntitiesManager::getTransition(Archetype* archetype, const int32_t type, const bool add)
+    {
+        ArchetypeEdge& edge = archetype->getEdge(type);
+        Archetype*& target = add ? edge.add : edge.remove;
+        if (target != nullptr)
+        {
+            return target;
+        }
+
+        // Nothing to add (or remove)
+        if (archetype->hasType(type) == add)
+        {
+            target = archetype;
+            return target;
+        }
+
+        // Compute the types of the destination archetype
+        int32_t* types = new int32_t[archetype->typesCount + 1];
+        int32_t typesCount = 0;
+        for (int32_t i = 0; i < archetype->typesCount; i++)
+        {
+            if (archetype->types[i] != type)
+            {
+                types[typesCount++] = archetype->types[i];
+            }
+        }
+        if (add)
+        {
+            types[typesCount++] = type;
+        }
+        target = getArchetype(types, typesCount);
+        delete[] types;
+
+        // The way back is known as well
+        ArchetypeEdge& backEdge = target->getEdge(type);
+        (add ? backEdge.remove : backEdge.add) = archetype;
+        return target;
+    }
+
+    inline void EntitiesManager::moveEntities(Archetype* oldArchetype, Archetype* newArchetype, const int32_t* ids,
+                                              const int32_t count)
+    {
+        for (int32_t i = 0; i < oldArchetype->typesCount; i++)
+        {
+            const int32_t type = oldArchetype->types[i];
+            IComponentStorage* storage = ComponentTypes::storage(type);
+            if (newArchetype->hasType(type))
+            {
+                storage->swapComponents(ids, count, oldArchetype, newArchetype);
+            }
+            else
+            {
+                storage->removeComponents(ids, count, oldArchetype);
+            }
+        }
+
+        // Moved entities are the last ones of their new group
+        EntitiesTable* table = EntitiesTable::getInstance();
+        ComponentsGroup<Entity>* group =
+            ComponentStorage<Entity>::getInstance()->getArchetypeGroup(newArchetype)->second;
+        for (int32_t i = group->size - count; i < group->size; i++)
+        {
+            (*table)[group->getComponent(i)->id].archetype = newArchetype;
+        }
+    }
+
+    template <class TComponent, bool TAdd>
+    inline void EntitiesManager::migrateEntities(const Entity* entities, const int32_t count,
+                                                 const TComponent* values, const int32_t valuesStride)
+    {
+        struct Migration
+        {
+            EntityLocation location;
+            // Index of the entity in the given list, and of its value
+            int32_t index;
+        };
+
+        ComponentStorage<TComponent>* storage = ComponentStorage<TComponent>::getInstance();
+        const int32_t type = storage->typeId;
+        EntitiesTable* table = EntitiesTable::getInstance();
+
+        // Sort locations by archetype and id, so each archetype is migrated in a single pass
+        Migration* migrations = new Migration[count];
+        int32_t validCount = 0;
+        for (int32_t i = 0; i < count; i++)
+        {
+            if (table->isValid(entities[i]))
+            {
+                migrations[validCount++] = {(*table)[entities[i].id], i};
+                if (storage->events != nullptr && migrations[validCount - 1].location.archetype->hasType(type) != TAdd)
+                {
+                    (TAdd ? storage->events->added : storage->events->removed).push_back(entities[i]);
+                }
+            }
+        }
+        std::sort(migrations, migrations + validCount, [](const Migration& a, const Migration& b) {
+            return a.location.archetype->id != b.location.archetype->id
+                       ? a.location.archetype->id < b.location.archetype->id
+                       : a.location.row < b.location.row;
+        });
+
+        int32_t* ids = new int32_t[validCount];
+        TComponent* batchValues = TAdd ? (TComponent*)malloc(validCount * sizeof(TComponent)) : nullptr;
+        for (int32_t first = 0, last = 0; first < validCount; first = last)
+        {
+            Archetype* oldArchetype = migrations[first].location.archetype;
+            for (; last < validCount && migrations[last].location.archetype == oldArchetype; last++)
+            {
+                ids[last] = migrations[last].location.row;
+            }
+            const int32_t batchCount = last - first;
+
+            Archetype* newArchetype = getTransition(oldArchetype, type, TAdd);
+            if (newArchetype == oldArchetype)
+            {
+                // Already has the component, just overwrite it (stamped as any other write)
+                if (TAdd)
+                {
+                    CompGroup<TComponent>* group = storage->getArchetypeGroup(oldArchetype)->second;
+                    for (int32_t i = first; i < last; i++)
+                    {
+                        *group->getComponent(ids[i]) = values[migrations[i].index * valuesStride];
+                        group->markChanged(ids[i], 1);
+                    }
+                }
+                continue;
+            }
+
+            moveEntities(oldArchetype, newArchetype, ids + first, batchCount);
+            if (TAdd)
+            {
+                for (int32_t i = 0; i < batchCount; i++)
+                {
+                    batchValues[i] = values[migrations[first + i].index * valuesStride];
+                }
+                createComponents<TComponent>(newArchetype, batchValues, batchCount);
+            }
+        }
+
+        free(batchValues);
+        delete[] ids;
+        delete[] migrations;
     }
 
     template <class TComponent>
-    inline CompGroupIt<TComponent> EntitiesManager::getComponentIterator(intptr_t mask)
+    inline void EntitiesManager::getComponentIterator(const GroupMask& mask, CompGroupIt<TComponent>& it)
     {
         ComponentStorage<TComponent>* storage = ComponentStorage<TComponent>::getInstance();
-        return storage->getComponentIterator(mask);
+        storage->getComponentIterator(mask, it);
     }
 
     template <class... TComponents>
-    inline tuple<CompGroupIt<TComponents>...> EntitiesManager::getComponentIterators()
+    inline void EntitiesManager::getComponentIterators(tuple<CompGroupIt<TComponents>...>& its)
     {
-        intptr_t mask = getTypeMask<TComponents...>();
-        return {getComponentIterator<TComponents>(mask)...};
+        using expander = int[];
+        const GroupMask& mask = getTypeMask<TComponents...>();
+        expander{0, ((void)getComponentIterator<TComponents>(mask, std::get<CompGroupIt<TComponents>>(its)), 0)...};
     }
 
-    template <class TComponent, class... TComponents>
-    inline TComponent* EntitiesManager::createComponent(MaskArray<sizeof...(TComponents)> maskArray,
-                                                        const TComponent& arg)
+    template <class... TComponents, class TFunction, int... S>
+    inline void EntitiesManager::forEachChunkUnfold(TFunction& function, seq<S...>)
+    {
+        using expander = int[];
+        const GroupMask& mask = getTypeMask<ComponentType<TComponents>...>();
+        // Every storage matches the same groups, in the same (mask) order
+        const tuple<QueryGroups<ComponentType<TComponents>>*...> queries(
+            &ComponentStorage<ComponentType<TComponents>>::getInstance()->getQuery(mask)->second...);
+        const int32_t groupCount = (int32_t)std::get<0>(queries)->size();
+        for (int32_t i = 0; i < groupCount; i++)
+        {
+            const tuple<ComponentsGroup<ComponentType<TComponents>>*...> groups((*std::get<S>(queries))[i]->second...);
+            const int32_t groupSize = std::get<0>(groups)->size;
+            expander{0, ((void)(ComponentAccess<TComponents>::readOnly
+                                    ? void()
+                                    : std::get<S>(groups)->markChanged(0, groupSize)),
+                         0)...};
+            tuple<CompIt<ComponentType<TComponents>>...> its(
+                CompIt<ComponentType<TComponents>>(std::get<S>(groups)->pages.pages, std::get<S>(groups)->baseOffset,
+                                                   std::get<S>(groups)->tipOffset, groupSize, nullptr)...);
+            int32_t fetchId = 0;
+            while (fetchId < groupSize)
+            {
+                int32_t chunkSize = groupSize - fetchId;
+                auto fetch = [fetchId, &chunkSize](auto& it) {
+                    int32_t size;
+                    auto chunk = it.getChunk(fetchId, size);
+                    chunkSize = (size < chunkSize) ? size : chunkSize;
+                    return chunk;
+                };
+                // Braced initialization fetches every chunk (in order) before the function is called
+                const tuple<ComponentPointer<TComponents>...> chunks{fetch(std::get<S>(its))...};
+                function(chunkSize, std::get<S>(chunks)...);
+                fetchId += chunkSize;
+            }
+        }
+    }
+
+    template <class... TComponents, class TFunction>
+    inline void EntitiesManager::forEachChunk(TFunction&& function)
+    {
+        forEachChunkUnfold<TComponents...>(function, typename gens<sizeof...(TComponents)>::type());
+    }
+
+    template <class... TComponents, class TFunction>
+    inline void EntitiesManager::each(TFunction&& function)
+    {
+        forEachChunk<TComponents...>(
+            [&function](const int32_t count, ComponentPointer<TComponents> const... components) {
+                for (int32_t i = 0; i < count; i++)
+                {
+                    function(components[i]...);
+                }
+            });
+    }
+
+    template <class TComponent>
+    inline TComponent* EntitiesManager::createComponent(const Archetype* archetype, const TComponent& arg)
+    {
+        ComponentStorage<TComponent>* storage = ComponentStorage<TComponent>::getInstance();
+        return storage->addComponent(archetype, &arg, 1)->getLastComponent();
+    }
+
+    template <class TComponent>
+    inline ComponentsGroup<TComponent>* EntitiesManager::createComponents(const Archetype* archetype,
+                                                                          const TComponent* args, int32_t count)
     {
         ComponentStorage<TComponent>* storage = ComponentStorage<TComponent>::getInstance();
-        return storage->addComponent(maskArray.data(), sizeof...(TComponents), arg);
+        return storage->addComponent(archetype, args, count);
     }
 
     template <class... TComponents>
-    inline Entity* EntitiesManager::createComponents(TComponents... args)
+    inline Entity EntitiesManager::createComponents(TComponents... args)
     {
         using expander = int[];
-        MaskArray<sizeof...(TComponents) + 1> masks = getMaskArray<Entity, TComponents...>();
-        Entity* entity = createComponent<Entity, Entity, TComponents...>(masks);
-		entity->compTypes = new intptr_t[sizeof...(TComponents) + 1];
-		memcpy(entity->compTypes, masks.data(), (sizeof...(TComponents) + 1) * sizeof(intptr_t));
-		entity->typesCount = sizeof...(TComponents) + 1;
-        expander{0, ((void)(createComponent<TComponents, Entity, TComponents...>(masks, args)), 0)...};
+        Archetype* archetype = getArchetype<Entity, TComponents...>();
+        Entity entity;
+        EntitiesTable::getInstance()->create(archetype, &entity, 1);
+        createComponent<Entity>(archetype, entity);
+        expander{0, ((void)(createComponent<TComponents>(archetype, args)), 0)...};
+        recordEvents(archetype, &entity, 1, true);
         return entity;
     }
 
     template <class... TComponents>
-    inline Entity* EntitiesManager::createComponents()
+    inline Entity EntitiesManager::createComponents()
     {
         using expander = int[];
-        MaskArray<sizeof...(TComponents) + 1> masks = getMaskArray<Entity, TComponents...>();
-        Entity* entity = createComponent<Entity, Entity, TComponents...>(masks);
-		entity->compTypes = new intptr_t[sizeof...(TComponents) + 1];
-		memcpy(entity->compTypes, masks.data(), (sizeof...(TComponents) + 1) * sizeof(intptr_t));
-		entity->typesCount = sizeof...(TComponents) + 1;
-        expander{0, ((void)(createComponent<TComponents, Entity, TComponents...>(masks)), 0)...};
+        Archetype* archetype = getArchetype<Entity, TComponents...>();
+        Entity entity;
+        EntitiesTable::getInstance()->create(archetype, &entity, 1);
+        createComponent<Entity>(archetype, entity);
+        expander{0, ((void)(createComponent<TComponents>(archetype)), 0)...};
+        recordEvents(archetype, &entity, 1, true);
         return entity;
     }
 
+    inline bool EntitiesManager::isValid(const Entity& entity)
+    {
+        return EntitiesTable::getInstance()->isValid(entity);
+    }
+
+    template <class TComponent>
+    inline TComponent* EntitiesManager::get(const Entity entity)
+    {
+        EntitiesTable* table = EntitiesTable::getInstance();
+        _ASSERT(table->isValid(entity));
+        const EntityLocation& location = (*table)[entity.id];
+        ComponentStorage<ComponentType<TComponent>>* storage =
+            ComponentStorage<ComponentType<TComponent>>::getInstance();
+        // The group lookup would create an empty group for archetypes lacking the type
+        _ASSERT(location.archetype->hasType(storage->typeId));
+        ComponentsGroup<ComponentType<TComponent>>* group = storage->getArchetypeGroup(location.archetype)->second;
+        if (!ComponentAccess<TComponent>::readOnly)
+        {
+            group->markChanged(location.row, 1);
+        }
+        return group->getComponent(location.row);
+    }
+
+    template <class TComponent>
+    inline TComponent* EntitiesManager::tryGet(const Entity entity)
+    {
+        EntitiesTable* table = EntitiesTable::getInstance();
+        if (!table->isValid(entity))
+        {
+            return nullptr;
+        }
+        const EntityLocation& location = (*table)[entity.id];
+        ComponentStorage<ComponentType<TComponent>>* storage =
+            ComponentStorage<ComponentType<TComponent>>::getInstance();
+        if (!location.archetype->hasType(storage->typeId))
+        {
+            return nullptr;
+        }
+        ComponentsGroup<ComponentType<TComponent>>* group = storage->getArchetypeGroup(location.archetype)->second;
+        if (!ComponentAccess<TComponent>::readOnly)
+        {
+            group->markChanged(location.row, 1);
+        }
+        return group->getComponent(location.row);
+    }
+
+    template <class TComponent>
+    inline void EntitiesManager::get(const Entity* entities, const int32_t count, TComponent* out)
+    {
+        struct Request
+        {
+            const TComponent* comp;
+            int32_t index;
+        };
+
+        // Resolve all locations first
+        Request* requests = new Request[count];
+        for (int32_t i = 0; i < count; i++)
+        {
+            requests[i].comp = get<const TComponent>(entities[i]);
+            requests[i].index = i;
+        }
+
+        // Gather in memory order
+        std::sort(requests, requests + count,
+                  [](const Request& a, const Request& b) { return a.comp < b.comp; });
+        for (int32_t i = 0; i < count; i++)
+        {
+            out[requests[i].index] = *requests[i].comp;
+        }
+
+        delete[] requests;
+    }
+
     template <class... TComponents>
     inline Entity EntitiesManager::createEntity(TComponents... args)
     {
-        return *createComponents<TComponents...>(args...);
+        return createComponents<TComponents...>(args...);
     }
 
     template <class... TComponents>
     inline Entity EntitiesManager::createEntity()
     {
-        return *createComponents<TComponents...>();
+        return createComponents<TComponents...>();
     }
 
     template <class... TComponents>
-    inline void EntitiesManager::removeEntity(Entity& entity)
+    inline Entity* EntitiesManager::createEntities(const int32_t count)
     {
-        _ASSERT(entity.id != -1);
-        GroupMask typeMask(entity.compTypes, entity.typesCount);
-        for (int32_t i = 0; i < entity.typesCount; i++)
+        return createEntities<TComponents...>(count, TComponents()...);
+    }
+
+    template <class... TComponents>
+    inline Entity* EntitiesManager::createEntities(const int32_t count, const TComponents&... values)
+    {
+        using expander = int[];
+        // Replicate initial values so every storage receives a single batch
+        tuple<TComponents*...> buffers = {(TComponents*)malloc(count * sizeof(TComponents))...};
+        for (int32_t i = 0; i < count; i++)
         {
-            IComponentStorage* storage = reinterpret_cast<IComponentStorage*>(entity.compTypes[i]);
-            storage->removeComponent(entity.id, typeMask);
+            expander{0, ((void)(std::get<TComponents*>(buffers)[i] = values), 0)...};
         }
-        // Set as invalid
-        entity.id = -1;
+        Entity* entities =
+            createEntities<TComponents...>(count, (const TComponents*)std::get<TComponents*>(buffers)...);
+        expander{0, ((void)free(std::get<TComponents*>(buffers)), 0)...};
+        return entities;
     }
 
+    template <class... TComponents>
+    inline Entity* EntitiesManager::createEntities(const int32_t count, const TComponents*... values)
+    {
+        using expander = int[];
+        Archetype* archetype = getArchetype<Entity, TComponents...>();
+        Entity* entities = new Entity[count];
+        EntitiesTable::getInstance()->create(archetype, entities, count);
+        // Locations are updated as the entities are added to their group
+        createComponents<Entity>(archetype, entities, count);
+        expander{0, ((void)(createComponents<TComponents>(archetype, values, count)), 0)...};
+        recordEvents(archetype, entities, count, true);
+        return entities;
+    }
+
+    template <class TComponent>
+    inline void EntitiesManager::addComponent(Entity entity, const TComponent& value)
+    {
+        migrateEntities<TComponent, true>(&entity, 1, &value, 0);
+    }
+
+    template <class TComponent>
+    inline void EntitiesManager::removeComponent(Entity entity)
+    {
+        migrateEntities<TComponent, false>(&entity, 1, nullptr, 0);
+    }
+
+    template <class TComponent>
+    inline void EntitiesManager::addComponents(const Entity* entities, const int32_t count,
+                                               const TComponent& value)
+    {
+        migrateEntities<TComponent, true>(entities, count, &value, 0);
+    }
+
+    template <class TComponent>
+    inline void EntitiesManager::addComponents(const Entity* entities, const int32_t count, const TComponent* values)
+    {
+        migrateEntities<TComponent, true>(entities, count, values, 1);
+    }
+
+    template <class TComponent>
+    inline void EntitiesManager::removeComponents(const Entity* entities, const int32_t count)
+    {
+        migrateEntities<TComponent, false>(entities, count, nullptr, 0);
+    }
+
+    inline bool EntitiesManager::removeEntity(Entity entity)
+    {
+        EntitiesTable* table = EntitiesTable::getInstance();
+        if (!table->isValid(entity))
+        {
+            return false;
+        }
+        const EntityLocation& location = (*table)[entity.id];
+        Archetype* archetype = location.archetype;
+        const int32_t row = location.row;
+        for (int32_t i = 0; i < archetype->typesCount; i++)
+        {
+            IComponentStorage* storage = ComponentTypes::storage(archetype->types[i]);
+            storage->removeComponent(row, archetype);
+        }
+        recordEvents(archetype, &entity, 1, false);
+        // Invalidate handle
+        table->destroy(entity);
+        return true;
+    }
+
+    inline int32_t EntitiesManager::destroyEntities(const Entity* entities, const int32_t count)
+    {
+        EntitiesTable* table = EntitiesTable::getInstance();
+        const int32_t archetypesCount = (int32_t)getArchetypes().size();
+
+        // Bucket rows by archetype (counting sort), so each archetype is removed in a single pass
+        Archetype** archetypes = new Archetype*[archetypesCount];
+        int32_t* offsets = new int32_t[archetypesCount + 1]();
+        for (int32_t i = 0; i < count; i++)
+        {
+            if (table->isValid(entities[i]))
+            {
+                Archetype* archetype = (*table)[entities[i].id].archetype;
+                archetypes[archetype->id] = archetype;
+                offsets[archetype->id + 1]++;
+                recordEvents(archetype, entities + i, 1, false);
+            }
+        }
+        for (int32_t i = 0; i < archetypesCount; i++)
+        {
+            offsets[i + 1] += offsets[i];
+        }
+        int32_t* rows = new int32_t[offsets[archetypesCount]];
+        int32_t* cursors = new int32_t[archetypesCount];
+        memcpy(cursors, offsets, archetypesCount * sizeof(int32_t));
+        for (int32_t i = 0; i < count; i++)
+        {
+            if (table->isValid(entities[i]))
+            {
+                const EntityLocation& location = (*table)[entities[i].id];
+                rows[cursors[location.archetype->id]++] = location.row;
+            }
+        }
+
+        std::vector<uint8_t> marks;
+        for (int32_t a = 0; a < archetypesCount; a++)
+        {
+            int32_t* ids = rows + offsets[a];
+            int32_t idsCount = offsets[a + 1] - offsets[a];
+            if (idsCount == 0)
+            {
+                continue;
+            }
+
+            // Sort ids (dropping repeated ones), marking them if they are dense enough
+            const int32_t rowsCount = *std::max_element(ids, ids + idsCount) + 1;
+            if (idsCount * 8 >= rowsCount)
+            {
+                marks.assign(rowsCount, 0);
+                for (int32_t i = 0; i < idsCount; i++)
+                {
+                    marks[ids[i]] = 1;
+                }
+                // The last row is marked, so ids are never written past the bucket
+                idsCount = 0;
+                for (int32_t row = 0; row < rowsCount; row++)
+                {
+                    ids[idsCount] = row;
+                    idsCount += marks[row];
+                }
+            }
+            else
+            {
+                std::sort(ids, ids + idsCount);
+                idsCount = (int32_t)(std::unique(ids, ids + idsCount) - ids);
+            }
+
+            const Archetype* archetype = archetypes[a];
+            for (int32_t i = 0; i < archetype->typesCount; i++)
+            {
+                IComponentStorage* storage = ComponentTypes::storage(archetype->types[i]);
+                storage->removeComponents(ids, idsCount, archetype);
+            }
+        }
+
+        // Invalidate handles, repeated ones are already invalid
+        int32_t removedCount = 0;
+        for (int32_t i = 0; i < count; i++)
+        {
+            if (table->isValid(entities[i]))
+            {
+                table->destroy(entities[i]);
+                removedCount++;
+            }
+        }
+
+        delete[] cursors;
+        delete[] rows;
+        delete[] offsets;
+        delete[] archetypes;
+        return removedCount;
+    }
+
+    inline void EntitiesManager::recordEvents(const Archetype* archetype, const Entity* entities,
+                                              const int32_t count, const bool added)
+    {
+        if (ComponentEvents::enabledCount() == 0)
+        {
+            return;
+        }
+        for (int32_t i = 0; i < archetype->typesCount; i++)
+        {
+            ComponentEvents* events = ComponentTypes::storage(archetype->types[i])->events;
+            if (events != nullptr)
+            {
+                std::vector<Entity>& list = added ? events->added : events->removed;
+                list.insert(list.end(), entities, entities + count);
+            }
+        }
+    }
+
+    template <class TComponent>
+    inline const ComponentEvents& EntitiesManager::getEvents()
+    {
+        ComponentStorage<TComponent>* storage = ComponentStorage<TComponent>::getInstance();
+        if (storage->events == nullptr)
+        {
+            storage->events = new ComponentEvents();
+            ComponentEvents::enabledCount()++;
+        }
+        return *storage->events;
+    }
+
+    inline void EntitiesManager::syncEvents()
+    {
+        if (ComponentEvents::enabledCount() == 0)
+        {
+            return;
+        }
+        for (int32_t type = 0; type < ComponentTypes::count(); type++)
+        {
+            IComponentStorage* storage = ComponentTypes::storage(type);
+            if (storage != nullptr && storage->events != nullptr)
+            {
+                storage->events->publish(type);
+            }
+        }
+    }
+
+    inline void EntitiesManager::compact()
+    {
+        for (int32_t type = 0; type < ComponentTypes::count(); type++)
+        {
+            IComponentStorage* storage = ComponentTypes::storage(type);
+            if (storage != nullptr)
+            {
+                storage->compact();
+            }
+        }
+    }
+
+    /**
+     * @brief Stream of the entities that gained a component type during the last frame (and still have it).
+     * Replaces full scans with work proportional to churn, recording starts on first use.
+     */
+    template <class TComponent>
+    struct Added
+    {
+        inline static const std::vector<Entity>& entities()
+        {
+            return EntitiesManager::getEvents<TComponent>().frameAdded;
+        }
+    };
+
+    /**
+     * @brief Stream of the entities that lost a component type during the last frame (or were destroyed).
+     * Recording starts on first use.
+     */
+    template <class TComponent>
+    struct Removed
+    {
+        inline static const std::vector<Entity>& entities()
+        {
+            return EntitiesManager::getEvents<TComponent>().frameRemoved;
+        }
+    };
+
 } // namespace rv
 
 #endif
\ No newline at end of file
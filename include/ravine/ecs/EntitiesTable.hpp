@@ -0,0 +1,135 @@
+#ifndef ENTITIESTABLE_HPP
+#define ENTITIESTABLE_HPP
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Entity.hpp"
+#include "FastMath.h"
+
+namespace rv
+{
+    /**
+     * @brief Current location of an entity: its archetype and its id within the archetype groups.
+     */
+    struct EntityLocation
+    {
+        /**
+         * @brief Archetype of the entity, nullptr while the slot is free.
+         */
+        Archetype* archetype;
+        /**
+         * @brief Component id of the entity in its groups, or the next free slot while the slot is free.
+         */
+        int32_t row;
+        /**
+         * @brief Incremented whenever the slot is freed, invalidating outstanding handles.
+         */
+        int32_t generation;
+    };
+
+    /**
+     * @brief Dense table mapping entity handles to their current location.
+     * Rows are kept up to date by the Entity groups, so handles remain valid while entities move around.
+     */
+    class EntitiesTable
+    {
+      private:
+        EntityLocation* locations;
+        int32_t size = 0;
+        int32_t capacity = 0;
+        int32_t freeSlot = -1;
+
+        inline void grow(int32_t newCapacity);
+
+      public:
+        EntitiesTable() : locations((EntityLocation*)malloc(64 * sizeof(EntityLocation))), capacity(64) {}
+
+        ~EntitiesTable() { free(locations); }
+
+        inline EntityLocation& operator[](const int32_t id) { return locations[id]; }
+
+        inline bool isValid(const Entity& entity) const;
+
+        /**
+         * @brief Allocates handles for new entities, their rows are set once they are added to their groups.
+         *
+         * @param archetype Archetype of the new entities.
+         * @param entities Output list of handles.
+         * @param count Amount of handles to be allocated.
+         */
+        inline void create(Archetype* archetype, Entity* entities, int32_t count);
+
+        /**
+         * @brief Frees the slot of an entity, so its handle (and copies of it) become invalid.
+         */
+        inline void destroy(const Entity& entity);
+
+        inline static EntitiesTable* getInstance();
+    };
+
+    inline void EntitiesTable::grow(int32_t newCapacity)
+    {
+        const int32_t grow = max(capacity, newCapacity) * 1.2f;
+        EntityLocation* newLocations = (EntityLocation*)malloc(grow * sizeof(EntityLocation));
+        memcpy(newLocations, locations, size * sizeof(EntityLocation));
+        free(locations);
+        locations = newLocations;
+        capacity = grow;
+    }
+
+    inline bool EntitiesTable::isValid(const Entity& entity) const
+    {
+        if (entity.id < 0 || entity.id >= size)
+        {
+            return false;
+        }
+        const EntityLocation& location = locations[entity.id];
+        return location.generation == entity.generation && location.archetype != nullptr;
+    }
+
+    inline void EntitiesTable::create(Archetype* archetype, Entity* entities, const int32_t count)
+    {
+        if (size + count > capacity)
+        {
+            grow(size + count);
+        }
+
+        for (int32_t i = 0; i < count; i++)
+        {
+            // Reuse free slots first
+            int32_t id = freeSlot;
+            if (id != -1)
+            {
+                freeSlot = locations[id].row;
+            }
+            else
+            {
+                id = size++;
+                locations[id].generation = 0;
+            }
+            locations[id].archetype = archetype;
+            locations[id].row = -1;
+            entities[i].id = id;
+            entities[i].generation = locations[id].generation;
+        }
+    }
+
+    inline void EntitiesTable::destroy(const Entity& entity)
+    {
+        EntityLocation& location = locations[entity.id];
+        location.archetype = nullptr;
+        location.row = freeSlot;
+        location.generation++;
+        freeSlot = entity.id;
+    }
+
+    inline EntitiesTable* EntitiesTable::getInstance()
+    {
+        static EntitiesTable* table = new EntitiesTable();
+        return table;
+    }
+
+} // namespace rv
+
+#endif
\ No newline at end of file
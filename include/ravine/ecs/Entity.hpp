@@ -10,33 +10,23 @@ using std::array;
 namespace rv
 {
 
+    struct Archetype;
+
+    /**
+     * @brief Stable entity handle, resolved through the \see{EntitiesTable}.
+     */
     struct Entity
     {
+        /**
+         * @brief Slot of the entity in the \see{EntitiesTable}.
+         */
         int32_t id;
-        int32_t typesCount;
-        intptr_t* compTypes;
-
-        constexpr Entity() : id(0), typesCount(0), compTypes(nullptr) { }
-
-        Entity(const Entity& other) : id(other.id), typesCount(other.typesCount)
-        {
-            compTypes = new intptr_t[typesCount];
-            memcpy(compTypes, other.compTypes, sizeof(intptr_t) * typesCount);
-        }
-
-        Entity(Entity&& other) : id(other.id), typesCount(other.typesCount), compTypes(other.compTypes)
-        {
-            other.id = -1;
-            other.typesCount = 0;
-            other.compTypes = nullptr;
-        }
-
-        ~Entity()
-        {
-            id = -1;
-            typesCount = 0;
-            delete[] compTypes;
-        }
+        /**
+         * @brief Generation of the slot when the entity was created, stale handles don't match it anymore.
+         */
+        int32_t generation;
+
+        constexpr Entity() : id(-1), generation(0) { }
 
         void print() { fprintf(stdout, "Entity(%i)", id); }
     };
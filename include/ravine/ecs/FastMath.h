@@ -56,57 +56,24 @@ namespace rv
         return x ^ (x >> 1);
     }
 
-    inline intptr_t* getMaskCombinations(const intptr_t* seedMasks, const int32_t maskCount, int32_t& combCount)
-    {
-        // Calculate number of possible combinations
-        combCount = (1u << maskCount) - 1 /*Exclude empty set*/;
-        int32_t* compIt = new int32_t[maskCount];
-        intptr_t* combs = new intptr_t[combCount];
-
-        // Process all combinations, from (N,N) to (N,1)
-        int32_t combIt = 0;
-        for (int32_t compCount = maskCount; compCount > 0; compCount--)
-        {
-            // Setup iterators and sizes for (N,compCount)
-            for (int32_t i = 0; i < compCount; i++)
-            {
-                compIt[i] = i;
-            }
-
-            // Calcualte every combination of (N,compCount)
-            int32_t curIncIt = compCount - 1;
-            do
-            {
-                // Compute current Combinations
-                combs[combIt] = 0;
-                for (int32_t i = 0; i < compCount; i++)
-                {
-                    combs[combIt] += seedMasks[compIt[i]];
-                }
-
-                // Find current incrementing iterator
-                for (int32_t i = compCount - 1; i >= 1; i--)
-                {
-                    const int32_t limit = maskCount - (compCount - i);
-                    curIncIt -= 1 - signMask(compIt[curIncIt] - limit);
-                }
-
-                // Update component iterators
-                int32_t lastComp = ++compIt[curIncIt];
-                for (int32_t i = curIncIt + 1; i < compCount; i++)
-                {
-                    compIt[i] = ++lastComp;
-                }
-                // Reset curent incrementing cursor
-                curIncIt = compCount - 1;
-
-                // Increment combination iterator
-                combIt++;
-            } while (compIt[0] <= (maskCount - compCount));
-        }
+    /**
+     * @brief Returns the base 2 logarithm of the given number, rounded down.
+     *
+     * @param x Value whose logarithm will be returned, must be positive.
+     * @return constexpr int32_t Index of the highest set bit.
+     */
+    constexpr int32_t log2Floor(const uint32_t x) { return x <= 1 ? 0 : 1 + log2Floor(x >> 1); }
 
-        delete[] compIt;
-        return combs;
+    /**
+     * @brief Rounds the given number up to a multiple of the given power of two.
+     *
+     * @param x Value to be rounded, must not be negative.
+     * @param alignment Power of two the result is a multiple of.
+     * @return constexpr int32_t Smallest multiple of 'alignment' not below 'x'.
+     */
+    constexpr int32_t alignUp(const int32_t x, const int32_t alignment)
+    {
+        return (x + alignment - 1) & ~(alignment - 1);
     }
 
 } // namespace rv
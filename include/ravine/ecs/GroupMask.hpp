@@ -0,0 +1,108 @@
+#ifndef GROUPMASK_HPP
+#define GROUPMASK_HPP
+
+#include <stdint.h>
+
+#include "ComponentTypes.hpp"
+
+namespace rv
+{
+    /**
+     * @brief Signature of a set of component types, one bit per type id.
+     */
+    struct GroupMask
+    {
+        static constexpr int32_t wordsCount = (RV_MAX_COMPONENTS + 63) / 64;
+
+        /**
+         * @brief Bitset of all type ids this mask represents.
+         */
+        uint64_t words[wordsCount];
+        /**
+         * @brief Amount of types this mask represents.
+         */
+        int32_t typesCount;
+
+        constexpr GroupMask() : words(), typesCount(0) {}
+
+        inline GroupMask(const int32_t* types, const int32_t count) : words(), typesCount(0)
+        {
+            for (int32_t i = 0; i < count; i++)
+            {
+                set(types[i]);
+            }
+        }
+
+        inline void set(const int32_t typeId)
+        {
+            uint64_t& word = words[typeId >> 6];
+            const uint64_t bit = uint64_t(1) << (typeId & 63);
+            typesCount += (word & bit) == 0;
+            word |= bit;
+        }
+
+        inline bool test(const int32_t typeId) const { return (words[typeId >> 6] >> (typeId & 63)) & 1; }
+
+        /**
+         * @brief Superset test, whether this mask has every type of the other one.
+         */
+        inline bool contains(const GroupMask& other) const
+        {
+            uint64_t missing = 0;
+            for (int32_t i = 0; i < wordsCount; i++)
+            {
+                missing |= other.words[i] & ~words[i];
+            }
+            return missing == 0;
+        }
+
+        /**
+         * @brief Whether this mask shares any type with the other one.
+         */
+        inline bool intersects(const GroupMask& other) const
+        {
+            uint64_t shared = 0;
+            for (int32_t i = 0; i < wordsCount; i++)
+            {
+                shared |= words[i] & other.words[i];
+            }
+            return shared != 0;
+        }
+
+        inline bool operator==(const GroupMask& other) const
+        {
+            uint64_t diff = 0;
+            for (int32_t i = 0; i < wordsCount; i++)
+            {
+                diff |= words[i] ^ other.words[i];
+            }
+            return diff == 0;
+        }
+    };
+
+    /**
+     * @brief Group Mask Compare operation.
+     * Masks with more types come first, so groups with more types are stored first.
+     */
+    struct GroupMaskCmp
+    {
+        inline bool operator()(const GroupMask& a, const GroupMask& b) const
+        {
+            if (a.typesCount != b.typesCount)
+            {
+                return a.typesCount > b.typesCount;
+            }
+            for (int32_t i = 0; i < GroupMask::wordsCount; i++)
+            {
+                if (a.words[i] != b.words[i])
+                {
+                    return a.words[i] < b.words[i];
+                }
+            }
+            return false;
+        }
+    };
+
+} // namespace rv
+
+#endif
\ No newline at end of file
@@ -2,17 +2,40 @@
 # define ICOMPONENTSTORAGE_HPP
 
 #include <inttypes.h>
-#include "ComponentsGroup.hpp"
+#include "Archetype.hpp"
+#include "ComponentEvents.hpp"
 
 namespace rv
 {
     class IComponentStorage
     {
         public:
+        /**
+         * @brief Added and removed entities of the type, nullptr until its events are first used.
+         */
+        ComponentEvents* events = nullptr;
+
         IComponentStorage() = default;
-        virtual ~IComponentStorage() = default;
-        virtual inline void swapComponent(int32_t entityId, GroupMask oldTypeMask, GroupMask newTypeMask) = 0;
-        virtual inline void removeComponent(int32_t entityId, GroupMask typeMask) = 0;
+        virtual ~IComponentStorage() { delete events; }
+        /**
+         * @brief Moves a component from the group of an archetype to the group of another one.
+         */
+        virtual inline void swapComponent(int32_t entityId, const Archetype* oldArchetype,
+                                          const Archetype* newArchetype) = 0;
+        /**
+         * @brief Moves many components between the same groups, entity ids must be sorted (ascending).
+         */
+        virtual inline void swapComponents(const int32_t* entityIds, int32_t count, const Archetype* oldArchetype,
+                                           const Archetype* newArchetype) = 0;
+        virtual inline void removeComponent(int32_t entityId, const Archetype* archetype) = 0;
+        /**
+         * @brief Removes many components from the same group, entity ids must be sorted (ascending).
+         */
+        virtual inline void removeComponents(const int32_t* entityIds, int32_t count, const Archetype* archetype) = 0;
+        /**
+         * @brief Returns the slack reserved by every group, packing groups back to back.
+         */
+        virtual inline void compact() = 0;
     };
 } // namespace rv
 
@@ -6,6 +6,10 @@ class ISystem
   public:
     virtual ~ISystem() = default;
     virtual void update(double deltaTime) = 0;
+    /**
+     * @brief Prepares the system to run, called (outside of any update) before systems run concurrently.
+     */
+    virtual void prepare() {}
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,124 @@
+#ifndef QUERYFILTERS_HPP
+#define QUERYFILTERS_HPP
+
+#include <type_traits>
+
+#include "ComponentTraits.hpp"
+#include "GroupMask.hpp"
+#include "TemplateMaskPack.h"
+
+namespace rv
+{
+    /**
+     * @brief Component type a system runs through when present, its chunks are nullptr for archetypes lacking it.
+     */
+    template <class TComponent>
+    struct Optional
+    {
+    };
+
+    template <class TComponent>
+    struct ComponentAccess<Optional<TComponent>> : ComponentAccess<TComponent>
+    {
+        static constexpr bool optional = true;
+    };
+
+    /**
+     * @brief Component type a system runs through only where it changed since the system last ran.
+     * Changes are tracked per block of RV_CHANGE_BLOCK components, chunks are skipped unless any of their
+     * Changed types was written (by a system handed it as mutable, or through the API) in the meantime.
+     */
+    template <class TComponent>
+    struct Changed
+    {
+    };
+
+    template <class TComponent>
+    struct ComponentAccess<Changed<TComponent>> : ComponentAccess<TComponent>
+    {
+        static constexpr bool changed = true;
+    };
+
+    /**
+     * @brief Filter skipping the archetypes with any of the given types.
+     */
+    template <class... TComponents>
+    struct Without
+    {
+        inline static bool matches(const GroupMask& groupMask)
+        {
+            return !groupMask.intersects(MaskPack<TComponents...>::mask());
+        }
+    };
+
+    /**
+     * @brief Filter skipping the archetypes with none of the given types.
+     */
+    template <class... TComponents>
+    struct AnyOf
+    {
+        inline static bool matches(const GroupMask& groupMask)
+        {
+            return groupMask.intersects(MaskPack<TComponents...>::mask());
+        }
+    };
+
+    /**
+     * @brief Whether a query argument is a filter (matched against archetype masks, never fetched).
+     */
+    template <class T>
+    struct IsQueryFilter : std::false_type
+    {
+    };
+
+    template <class... TComponents>
+    struct IsQueryFilter<Without<TComponents...>> : std::true_type
+    {
+    };
+
+    template <class... TComponents>
+    struct IsQueryFilter<AnyOf<TComponents...>> : std::true_type
+    {
+    };
+
+    template <class... T>
+    struct TypeList
+    {
+    };
+
+    /**
+     * @brief Splits the arguments of a query in fetched component types and filters, keeping their order.
+     */
+    template <class... TArgs>
+    struct QueryArgs
+    {
+        using Components = TypeList<>;
+        using Filters = TypeList<>;
+    };
+
+    template <class T, class... TArgs>
+    struct QueryArgs<T, TArgs...>
+    {
+      private:
+        template <class TList>
+        struct Prepend;
+
+        template <class... TList>
+        struct Prepend<TypeList<TList...>>
+        {
+            using type = TypeList<T, TList...>;
+        };
+
+        using Rest = QueryArgs<TArgs...>;
+
+      public:
+        using Components = typename std::conditional<IsQueryFilter<T>::value, typename Rest::Components,
+                                                     typename Prepend<typename Rest::Components>::type>::type;
+        using Filters = typename std::conditional<IsQueryFilter<T>::value,
+                                                  typename Prepend<typename Rest::Filters>::type,
+                                                  typename Rest::Filters>::type;
+    };
+
+} // namespace rv
+
+#endif
\ No newline at end of file
@@ -0,0 +1,165 @@
+#ifndef SYSTEMMANAGER_HPP
+#define SYSTEMMANAGER_HPP
+
+#include <atomic>
+#include <vector>
+
+#include "BaseSystem.hpp"
+#include "ThreadPool.hpp"
+
+namespace rv
+{
+    /**
+     * @brief Runs systems every frame, concurrently whenever their component accesses don't conflict.
+     * Systems that conflict (one writes a type the other reads or writes) run in their registration order.
+     *
+     * Systems must not change the entities structure while running, structural changes should be recorded in a
+     * \see{CommandBuffer} and played back after \see{update}.
+     */
+    class SystemManager
+    {
+      private:
+        struct SystemNode
+        {
+            ISystem* system;
+            GroupMask reads;
+            GroupMask writes;
+            /**
+             * @brief Later systems that conflict with this one.
+             */
+            std::vector<int32_t> successors;
+            int32_t predecessorsCount = 0;
+            /**
+             * @brief Predecessors still running in the current frame.
+             */
+            std::atomic<int32_t> pending;
+        };
+
+        std::vector<SystemNode*> nodes;
+        ThreadPool pool;
+        std::atomic<int32_t> remaining;
+        double deltaTime = 0;
+
+        inline void run(int32_t nodeId);
+
+      public:
+        inline SystemManager(int32_t threadsCount = ThreadPool::defaultThreadsCount())
+            : pool(threadsCount), remaining(0)
+        {
+        }
+
+        ~SystemManager() { clear(); }
+
+        /**
+         * @brief Registers a system, its accesses are derived from its component types.
+         * Const component types (and entities) are read, every other type is written.
+         *
+         * @param system System to run every frame, not owned by the manager.
+         */
+        template <class TKernel, class TComponents, class TFilters>
+        inline void addSystem(QuerySystem<TKernel, TComponents, TFilters>* system);
+
+        /**
+         * @brief Registers a system with explicit accesses.
+         *
+         * @param system System to run every frame, not owned by the manager.
+         * @param reads Mask of the component types the system reads.
+         * @param writes Mask of the component types the system writes.
+         */
+        inline void addSystem(ISystem* system, const GroupMask& reads, const GroupMask& writes);
+
+        /**
+         * @brief Unregisters all systems.
+         */
+        inline void clear();
+
+        /**
+         * @brief Runs every registered system once, returning once all of them are done.
+         * This is the frame sync point, the component events recorded since the last update are published first.
+         *
+         * @param deltaTime Timespan between last and current frame (in seconds).
+         */
+        inline void update(double deltaTime);
+    };
+
+    template <class TKernel, class TComponents, class TFilters>
+    inline void SystemManager::addSystem(QuerySystem<TKernel, TComponents, TFilters>* system)
+    {
+        GroupMask reads;
+        GroupMask writes;
+        QuerySystem<TKernel, TComponents, TFilters>::getAccessMasks(reads, writes);
+        addSystem((ISystem*)system, reads, writes);
+    }
+
+    inline void SystemManager::addSystem(ISystem* system, const GroupMask& reads, const GroupMask& writes)
+    {
+        SystemNode* node = new SystemNode();
+        node->system = system;
+        node->reads = reads;
+        node->writes = writes;
+
+        // Every earlier conflicting system must finish first
+        const int32_t nodeId = (int32_t)nodes.size();
+        for (SystemNode* other : nodes)
+        {
+            if (other->writes.intersects(writes) || other->writes.intersects(reads) ||
+                other->reads.intersects(writes))
+            {
+                other->successors.push_back(nodeId);
+                node->predecessorsCount++;
+            }
+        }
+        nodes.push_back(node);
+    }
+
+    inline void SystemManager::clear()
+    {
+        for (SystemNode* node : nodes)
+        {
+            delete node;
+        }
+        nodes.clear();
+    }
+
+    inline void SystemManager::run(const int32_t nodeId)
+    {
+        SystemNode* node = nodes[nodeId];
+        node->system->update(deltaTime);
+
+        // Release the successors whose predecessors are all done
+        for (const int32_t successorId : node->successors)
+        {
+            if (nodes[successorId]->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                pool.submit([this, successorId]() { run(successorId); });
+            }
+        }
+        remaining.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    inline void SystemManager::update(const double deltaTime)
+    {
+        this->deltaTime = deltaTime;
+        EntitiesManager::syncEvents();
+
+        // Iterators are rebuilt serially, systems only read the storages while running
+        for (SystemNode* node : nodes)
+        {
+            node->system->prepare();
+            node->pending.store(node->predecessorsCount, std::memory_order_relaxed);
+        }
+
+        remaining.store((int32_t)nodes.size(), std::memory_order_release);
+        for (int32_t nodeId = 0; nodeId < (int32_t)nodes.size(); nodeId++)
+        {
+            if (nodes[nodeId]->predecessorsCount == 0)
+            {
+                pool.submit([this, nodeId]() { run(nodeId); });
+            }
+        }
+        pool.wait(remaining);
+    }
+
+} // namespace rv
+
+#endif
\ No newline at end of file
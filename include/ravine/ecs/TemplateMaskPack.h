@@ -3,31 +3,36 @@
 
 #include <array>
 #include "ComponentStorage.hpp"
+#include "GroupMask.hpp"
 
 namespace rv
 {
 
-    template <typename... T>
-    struct MaskPack;
+    template <int N>
+    using MaskArray = std::array<int32_t, N>;
 
-    template <>
-    struct MaskPack<>
+    template <typename... T>
+    struct MaskPack
     {
-        static constexpr intptr_t mask() { return 0; }
-    };
+        /**
+         * @brief Type ids of the pack, registering their storages on first use.
+         */
+        inline static const MaskArray<sizeof...(T)>& types()
+        {
+            static const MaskArray<sizeof...(T)> typeIds = {ComponentStorage<T>::getInstance()->typeId...};
+            return typeIds;
+        }
 
-    template <typename H, typename... T>
-    struct MaskPack<H, T...>
-    {
-        static constexpr size_t mask()
+        /**
+         * @brief Mask of the pack, computed once since type ids are only known at registration time.
+         */
+        inline static const GroupMask& mask()
         {
-            return reinterpret_cast<intptr_t>(ComponentStorage<H>::getInstance()) + MaskPack<T...>::mask();
+            static const GroupMask groupMask(types().data(), sizeof...(T));
+            return groupMask;
         }
     };
 
-    template <int N>
-    using MaskArray = std::array<intptr_t, N>;
-
 } // namespace rv
 
 #endif
\ No newline at end of file
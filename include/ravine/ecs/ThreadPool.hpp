@@ -0,0 +1,245 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rv
+{
+    /**
+     * @brief Fixed set of worker threads running submitted tasks, each worker owns a deque of tasks.
+     * Workers run their own tasks newest first and steal the oldest tasks of the others once they run out.
+     * Threads waiting for tasks help running them, so a pool without workers runs everything inline.
+     */
+    class ThreadPool
+    {
+      private:
+        /**
+         * @brief Tasks of a single thread, its owner works from the back while thieves take from the front.
+         */
+        struct WorkQueue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        /**
+         * @brief Queue of the current thread, if it is a worker.
+         */
+        struct WorkerSlot
+        {
+            const ThreadPool* pool;
+            int32_t queueId;
+        };
+
+        std::vector<std::thread> threads;
+        /**
+         * @brief One queue per worker, plus a last one shared by the threads outside the pool.
+         */
+        WorkQueue* queues;
+        int32_t queuesCount;
+        /**
+         * @brief Amount of tasks in all queues.
+         */
+        std::atomic<int32_t> queuedCount;
+        std::mutex sleepMutex;
+        std::condition_variable condition;
+        bool stopping = false;
+
+        inline static WorkerSlot& worker()
+        {
+            static thread_local WorkerSlot slot = {nullptr, -1};
+            return slot;
+        }
+
+        inline int32_t ownQueue() const { return worker().pool == this ? worker().queueId : queuesCount - 1; }
+
+        inline void push(int32_t queueId, std::function<void()>&& task);
+
+        /**
+         * @brief Takes a task from the own queue (newest first), stealing from the others (oldest first) if empty.
+         */
+        inline bool take(std::function<void()>& task);
+
+        inline void work(int32_t queueId);
+
+      public:
+        /**
+         * @brief Default amount of workers, one per hardware thread besides the calling one.
+         */
+        inline static int32_t defaultThreadsCount()
+        {
+            const int32_t hardwareThreads = (int32_t)std::thread::hardware_concurrency();
+            return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+        }
+
+        inline ThreadPool(int32_t threadsCount = defaultThreadsCount());
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool();
+
+        inline int32_t size() const { return (int32_t)threads.size(); }
+
+        /**
+         * @brief Queues a task on the calling worker (or on the shared queue, from outside the pool).
+         */
+        inline void submit(std::function<void()> task);
+
+        /**
+         * @brief Runs a single queued task on the calling thread.
+         *
+         * @return bool Whether there was a task to run.
+         */
+        inline bool runOne();
+
+        /**
+         * @brief Runs queued tasks on the calling thread until the given counter reaches zero.
+         */
+        inline void wait(const std::atomic<int32_t>& pending);
+
+        /**
+         * @brief Calls the function for every index in [0, count), returning once all calls are done.
+         * Contiguous ranges of indices are spread across the workers queues, idle threads steal the rest.
+         */
+        template <class TFunction>
+        inline void parallelFor(int32_t count, const TFunction& function);
+    };
+
+    inline ThreadPool::ThreadPool(const int32_t threadsCount)
+        : queues(new WorkQueue[threadsCount + 1]), queuesCount(threadsCount + 1), queuedCount(0)
+    {
+        for (int32_t i = 0; i < threadsCount; i++)
+        {
+            threads.emplace_back(&ThreadPool::work, this, i);
+        }
+    }
+
+    inline ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        condition.notify_all();
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        delete[] queues;
+    }
+
+    inline void ThreadPool::push(const int32_t queueId, std::function<void()>&& task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(queues[queueId].mutex);
+            queues[queueId].tasks.push_back(std::move(task));
+        }
+        queuedCount.fetch_add(1, std::memory_order_release);
+
+        // Wake a sleeping worker, the lock ensures it doesn't miss the new task
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        condition.notify_one();
+    }
+
+    inline bool ThreadPool::take(std::function<void()>& task)
+    {
+        const int32_t queueId = ownQueue();
+        {
+            WorkQueue& queue = queues[queueId];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty())
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                queuedCount.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        for (int32_t i = 1; i < queuesCount; i++)
+        {
+            WorkQueue& victim = queues[(queueId + i) % queuesCount];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                queuedCount.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline void ThreadPool::work(const int32_t queueId)
+    {
+        worker() = {this, queueId};
+        std::function<void()> task;
+        while (true)
+        {
+            if (take(task))
+            {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            condition.wait(lock, [this]() { return stopping || queuedCount.load(std::memory_order_acquire) > 0; });
+            if (stopping && queuedCount.load(std::memory_order_acquire) == 0)
+            {
+                return;
+            }
+        }
+    }
+
+    inline void ThreadPool::submit(std::function<void()> task)
+    {
+        push(ownQueue(), std::move(task));
+    }
+
+    inline bool ThreadPool::runOne()
+    {
+        std::function<void()> task;
+        if (!take(task))
+        {
+            return false;
+        }
+        task();
+        return true;
+    }
+
+    inline void ThreadPool::wait(const std::atomic<int32_t>& pending)
+    {
+        while (pending.load(std::memory_order_acquire) > 0)
+        {
+            if (!runOne())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    template <class TFunction>
+    inline void ThreadPool::parallelFor(const int32_t count, const TFunction& function)
+    {
+        std::atomic<int32_t> pending(count);
+        for (int32_t i = 0; i < count; i++)
+        {
+            push((int32_t)((int64_t)i * queuesCount / count), [&function, &pending, i]() {
+                function(i);
+                pending.fetch_sub(1, std::memory_order_acq_rel);
+            });
+        }
+        wait(pending);
+    }
+
+} // namespace rv
+
+#endif
\ No newline at end of file
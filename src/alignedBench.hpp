@@ -0,0 +1,129 @@
+#pragma once
+
+#include <ravine/ecs.h>
+
+#include "ibenchmark.h"
+
+// Entity counts the unaligned and aligned kernels are compared at
+#ifndef ALIGNED_ENTITIES_COUNT
+#define ALIGNED_ENTITIES_COUNT { 1'000, 100'000, 1'000'000 }
+#endif
+#ifndef ALIGNED_TICKS_COUNT
+#define ALIGNED_TICKS_COUNT 1'000
+#endif
+
+using namespace rv;
+
+static const int alignedEntitiesCount[] = ALIGNED_ENTITIES_COUNT;
+
+struct SimdPos
+{
+	float x;
+	float y;
+};
+
+struct SimdVel
+{
+	float x;
+	float y;
+};
+
+namespace rv
+{
+	// Each group owns its (aligned) buffer, so aligned systems can fetch these types
+	template <>
+	struct ComponentTraits<SimdPos> : ComponentTraits<void>
+	{
+		using Layout = GroupLayout;
+	};
+
+	template <>
+	struct ComponentTraits<SimdVel> : ComponentTraits<void>
+	{
+		using Layout = GroupLayout;
+	};
+}
+
+/// <summary>
+/// Integrates positions over arbitrary-length chunks, the compiler peels a scalar epilogue.
+/// </summary>
+class UnalignedMoveSystem : public StaticSystem<UnalignedMoveSystem, SimdPos, const SimdVel>
+{
+public:
+	inline void update(double deltaTime, int32_t batchSize, SimdPos* const posArray, const SimdVel* const velArray)
+	{
+		const float dt = (float)deltaTime;
+		for (int32_t i = 0; i < batchSize; i++)
+		{
+			posArray[i].x += velArray[i].x * dt;
+			posArray[i].y += velArray[i].y * dt;
+		}
+	}
+};
+
+/// <summary>
+/// Same as UnalignedMoveSystem, but runs through aligned chunks padded to a multiple of lanes.
+/// </summary>
+class AlignedMoveSystem : public AlignedSystem<AlignedMoveSystem, SimdPos, const SimdVel>
+{
+public:
+	inline void update(double deltaTime, const AlignedChunk& chunk, SimdPos* const posArray,
+					   const SimdVel* const velArray)
+	{
+		const float dt = (float)deltaTime;
+		for (int32_t i = 0; i < chunk.paddedSize(); i++)
+		{
+			posArray[i].x += velArray[i].x * dt;
+			posArray[i].y += velArray[i].y * dt;
+		}
+	}
+};
+
+/// <summary>
+/// Gap between kernels over arbitrary chunks (StaticSystem) and over aligned, padded ones (AlignedSystem).
+/// </summary>
+class AlignedBench
+{
+private:
+	/// <summary>
+	/// Ticks the system the set amount of times.
+	/// </summary>
+	/// <returns>Mean time of a tick (in us).</returns>
+	inline double tick(ISystem& system)
+	{
+		auto start = high_resolution_clock::now();
+		for (int t = 0; t < ALIGNED_TICKS_COUNT; t++)
+		{
+			system.update(1.0 / 60.0);
+		}
+		auto end = high_resolution_clock::now();
+		return duration_cast<nanoseconds>(end - start).count() / (1'000.0 * ALIGNED_TICKS_COUNT);
+	}
+
+public:
+	/// <summary>
+	/// Actually runs the benchmark, for each entity count.
+	/// </summary>
+	inline void run()
+	{
+		fprintf(stdout, "\n\n::Starting benchmark for Aligned Chunks::\n");
+
+		UnalignedMoveSystem unalignedSystem;
+		AlignedMoveSystem alignedSystem;
+		for (int entCount : alignedEntitiesCount)
+		{
+			fprintf(stdout, "\nTesting %i entities, %i ticks\n", entCount, ALIGNED_TICKS_COUNT);
+			Entity* entities = EntitiesManager::createEntities<SimdPos, SimdVel>(entCount);
+
+			const double unalignedTime = tick(unalignedSystem);
+			const double alignedTime = tick(alignedSystem);
+			fprintf(stdout, "Unaligned: %.3fus\n", unalignedTime);
+			fprintf(stdout, "Aligned: %.3fus (x%.2f)\n", alignedTime, unalignedTime / alignedTime);
+
+			EntitiesManager::destroyEntities(entities, entCount);
+			delete[] entities;
+		}
+
+		fprintf(stdout, "\n::Benchmark for Aligned Chunks complete::\n");
+	}
+};
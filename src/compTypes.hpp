@@ -1,5 +1,8 @@
 #pragma once
 
+#include <ravine/ecs.h>
+#include <utility>
+
 struct CompA
 {
 	float x;
@@ -16,4 +19,48 @@ struct CompC
 {
 	float x;
 	float y;
-};
\ No newline at end of file
+};
+
+// Amount of tag types, entities are spread across 2^TAGS_COUNT archetypes
+#ifndef TAGS_COUNT
+#define TAGS_COUNT 9
+#endif
+
+template <int N>
+struct Tag
+{
+	float value;
+};
+
+/// <summary>
+/// Adds the tag of each set bit of the entity index, spreading entities across many archetypes.
+/// </summary>
+template <int N>
+inline void addTag(const rv::Entity* entities, int entityCount, rv::Entity* buffer)
+{
+	int count = 0;
+	for (int i = 0; i < entityCount; i++)
+	{
+		if (i & (1 << N))
+		{
+			buffer[count++] = entities[i];
+		}
+	}
+	rv::EntitiesManager::addComponents<Tag<N>>(buffer, count);
+}
+
+template <int... N>
+inline void addTags(const rv::Entity* entities, int entityCount, std::integer_sequence<int, N...>)
+{
+	rv::Entity* buffer = new rv::Entity[entityCount];
+	(addTag<N>(entities, entityCount, buffer), ...);
+	delete[] buffer;
+}
+
+/// <summary>
+/// Spreads the given entities across the 2^TAGS_COUNT archetypes of the Many Archetypes test.
+/// </summary>
+inline void addTags(const rv::Entity* entities, int entityCount)
+{
+	addTags(entities, entityCount, std::make_integer_sequence<int, TAGS_COUNT>());
+}
\ No newline at end of file
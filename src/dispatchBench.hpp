@@ -0,0 +1,99 @@
+#pragma once
+
+#include <ravine/ecs.h>
+
+#include "ibenchmark.h"
+#include "compTypes.hpp"
+
+// Entity counts the virtual and static systems are compared at
+#ifndef DISPATCH_ENTITIES_COUNT
+#define DISPATCH_ENTITIES_COUNT { 1, 1'000, 100'000 }
+#endif
+#ifndef DISPATCH_TICKS_COUNT
+#define DISPATCH_TICKS_COUNT 1'000
+#endif
+
+using namespace rv;
+
+static const int dispatchEntitiesCount[] = DISPATCH_ENTITIES_COUNT;
+
+/// <summary>
+/// Integrates positions through the virtual update functions of BaseSystem.
+/// </summary>
+class VirtualMoveSystem : public BaseSystem<CompA, const CompB>
+{
+public:
+	inline void update(double deltaTime, int32_t batchSize, CompA* const posArray, const CompB* const velArray) final
+	{
+		for (int32_t i = 0; i < batchSize; i++)
+		{
+			posArray[i].x += velArray[i].x * (float)deltaTime;
+			posArray[i].y += velArray[i].y * (float)deltaTime;
+		}
+	}
+};
+
+/// <summary>
+/// Same as VirtualMoveSystem, but its update is resolved at compile time.
+/// </summary>
+class StaticMoveSystem : public StaticSystem<StaticMoveSystem, CompA, const CompB>
+{
+public:
+	inline void update(double deltaTime, int32_t batchSize, CompA* const posArray, const CompB* const velArray)
+	{
+		for (int32_t i = 0; i < batchSize; i++)
+		{
+			posArray[i].x += velArray[i].x * (float)deltaTime;
+			posArray[i].y += velArray[i].y * (float)deltaTime;
+		}
+	}
+};
+
+/// <summary>
+/// Gap between virtual (BaseSystem) and static (StaticSystem) dispatch of the per-chunk update.
+/// </summary>
+class DispatchBench
+{
+private:
+	/// <summary>
+	/// Ticks the system the set amount of times.
+	/// </summary>
+	/// <returns>Mean time of a tick (in us).</returns>
+	inline double tick(ISystem& system)
+	{
+		auto start = high_resolution_clock::now();
+		for (int t = 0; t < DISPATCH_TICKS_COUNT; t++)
+		{
+			system.update(1.0 / 60.0);
+		}
+		auto end = high_resolution_clock::now();
+		return duration_cast<nanoseconds>(end - start).count() / (1'000.0 * DISPATCH_TICKS_COUNT);
+	}
+
+public:
+	/// <summary>
+	/// Actually runs the benchmark, for each entity count.
+	/// </summary>
+	inline void run()
+	{
+		fprintf(stdout, "\n\n::Starting benchmark for System Dispatch::\n");
+
+		VirtualMoveSystem virtualSystem;
+		StaticMoveSystem staticSystem;
+		for (int entCount : dispatchEntitiesCount)
+		{
+			fprintf(stdout, "\nTesting %i entities, %i ticks\n", entCount, DISPATCH_TICKS_COUNT);
+			Entity* entities = EntitiesManager::createEntities<CompA, CompB>(entCount);
+
+			const double virtualTime = tick(virtualSystem);
+			const double staticTime = tick(staticSystem);
+			fprintf(stdout, "Virtual: %.3fus\n", virtualTime);
+			fprintf(stdout, "Static: %.3fus (x%.2f)\n", staticTime, virtualTime / staticTime);
+
+			EntitiesManager::destroyEntities(entities, entCount);
+			delete[] entities;
+		}
+
+		fprintf(stdout, "\n::Benchmark for System Dispatch complete::\n");
+	}
+};
\ No newline at end of file
@@ -16,6 +16,8 @@ using entt::basic_group;
 using entt::entity;
 using entt::exclude_t;
 using entt::get_t;
+using std::integer_sequence;
+using std::make_integer_sequence;
 
 typedef basic_group<entity, exclude_t<>, get_t<>, CompA, CompB> groupAB;
 typedef basic_group<entity, exclude_t<>, get_t<>, CompB, CompC> groupBC;
@@ -29,6 +31,14 @@ private:
 	groupBC gbc = reg.group<CompB, CompC>();
 	groupABC gabc = reg.group<CompA, CompB, CompC>();
 
+	/// <summary>
+	/// Adds the tag of each set bit of the entity index, mirroring the archetypes spread of Ravine.
+	/// </summary>
+	template <int... N>
+	inline void addTags(entity entity, int index, integer_sequence<int, N...>)
+	{
+		((index & (1 << N) ? (void)reg.emplace<Tag<N>>(entity) : (void)0), ...);
+	}
 
 public:
 	inline const char* getName() final
@@ -84,6 +94,16 @@ public:
 		}
 	}
 
+	inline void setupManyArchetypes(int entityCount) final
+	{
+		for (int i = 0; i < entityCount; i++)
+		{
+			auto entity = reg.create();
+			reg.emplace<CompA>(entity);
+			addTags(entity, i, make_integer_sequence<int, TAGS_COUNT>());
+		}
+	}
+
 	inline void tickOneComp(double dt) final
 	{
 		auto view = reg.view<CompA>();
@@ -95,6 +115,10 @@ public:
 			compA[i].y += dt;
 		}
 	}
+	inline void tickManyArchetypes(double dt) final
+	{
+		tickOneComp(dt);
+	}
 	inline void tickTwoCompSim(double dt) final
 	{
 		gab.each(
@@ -54,12 +54,14 @@ public:
 	inline virtual void setupTwoCompSim(int entityCount) = 0;
 	inline virtual void setupThreeComp(int entityCount) = 0;
 	inline virtual void setupThreeCompPair(int entityCount) = 0;
+	inline virtual void setupManyArchetypes(int entityCount) = 0;
 
 	inline virtual void tickOneComp(double deltaTime) = 0;
 	inline virtual void tickTwoCompSep(double deltaTime) = 0;
 	inline virtual void tickTwoCompSim(double deltaTime) = 0;
 	inline virtual void tickThreeComp(double deltaTime) = 0;
 	inline virtual void tickThreeCompPair(double deltaTime) = 0;
+	inline virtual void tickManyArchetypes(double deltaTime) = 0;
 
 	/// <summary>
 	/// Should be used for cleanup of the benchmark test data.
@@ -81,258 +83,34 @@ public:
 
 		fprintf(stdout, "\n\n::Starting benchmark for %s::\n", benchName.c_str());
 
-#pragma region One Comp Benchmark
-		fprintf(stdout, "\nStarting Test - *One Component*\n");
-		// Open Log File
-		string logName = logPrefix + " - One Component.csv";
-		fprintf(stdout, "Writting log to '%s'.\n", logName.c_str());
-		logFile = fopen(logName.c_str(), "w");
-		if (logFile == NULL)
-		{
-			fprintf(stderr, "Unable to create log file!\n");
-			exit(1);
-		}
-		for (int entCount : entitiesCount)
-		{
-			fprintf(stdout, "Testing with %i entities\n", entCount);
-			fprintf(logFile, "%i Entities;", entCount);
-
-			// Setup Benchmark
-			fprintf(stdout, "Allocating Entities... ");
-			setupOneComp(entCount);
-			fprintf(stdout, "Done! ");
+		runTest(logPrefix, "One Component", &IBenchmark::setupOneComp, &IBenchmark::tickOneComp);
+		runTest(logPrefix, "Two Components Separately", &IBenchmark::setupTwoCompSep, &IBenchmark::tickTwoCompSep);
+		runTest(logPrefix, "Two Components Simultaneously", &IBenchmark::setupTwoCompSim,
+			&IBenchmark::tickTwoCompSim);
+		runTest(logPrefix, "Three Components by Pairs", &IBenchmark::setupThreeCompPair,
+			&IBenchmark::tickThreeCompPair);
+		runTest(logPrefix, "Three Components Simultaneously", &IBenchmark::setupThreeComp,
+			&IBenchmark::tickThreeComp);
+		runTest(logPrefix, "Many Archetypes", &IBenchmark::setupManyArchetypes, &IBenchmark::tickManyArchetypes);
 
-			// Perform benchmark with the given iterations count
-			fprintf(stdout, "Performing tick simulations... ");
-			double acc = 0;
-			double deltaTime = 0.016;
-			for (size_t i = 0; i < ITERATIONS_COUNT; i++)
-			{
-				auto start = high_resolution_clock::now();
-
-				tickOneComp(deltaTime);
-
-				auto end = high_resolution_clock::now();
-				auto elapsed = duration_cast<nanoseconds>(end - start);
-				deltaTime = elapsed.count() / 1'000'000.0;
-				samples[i] = deltaTime;
-				acc += deltaTime;
-			}
-			fprintf(stdout, "Done! ");
-
-			// Calculate mean and std deviation values
-			mean = acc / (double)ITERATIONS_COUNT;
-			double var = 0;
-			for (size_t i = 0; i < ITERATIONS_COUNT; i++)
-			{
-				fprintf(logFile, "%.7f;", samples[i]);
-				var += (samples[i] - mean) * (samples[i] - mean);
-			}
-			fprintf(logFile, "\n");
-			var /= (double)ITERATIONS_COUNT;
-			stddev = sqrt(var);
-
-			// Cleanup
-			fprintf(stdout, "Performing clean-up... ");
-			cleanup();
-			fprintf(stdout, "Done!\n");
-
-			// Log
-			fprintf(stdout, "Finished with mean time %.7fms, and std-dev %.7fms!\n", mean, stddev);
-		}
-		fclose(logFile);
-#pragma endregion
-
-#pragma region Two Comp Separately Benchmark
-		fprintf(stdout, "\nStarting Test - *Two Components Separately*\n");
-		// Open Log File
-		logName = logPrefix + " - Two Components Separately.csv";
-		fprintf(stdout, "Writting log to '%s'.\n", logName.c_str());
-		logFile = fopen(logName.c_str(), "w");
-		if (logFile == NULL)
-		{
-			fprintf(stderr, "Unable to create log file!\n");
-			exit(1);
-		}
-		for (int entCount : entitiesCount)
-		{
-			fprintf(stdout, "Testing with %i entities\n", entCount);
-			fprintf(logFile, "%i Entities;", entCount);
-
-			// Setup Benchmark
-			fprintf(stdout, "Allocating Entities... ");
-			setupTwoCompSep(entCount);
-			fprintf(stdout, "Done! ");
-
-			// Perform benchmark with the given iterations count
-			fprintf(stdout, "Performing tick simulations... ");
-			double acc = 0;
-			double deltaTime = 0.016;
-			for (size_t i = 0; i < ITERATIONS_COUNT; i++)
-			{
-				auto start = high_resolution_clock::now();
-
-				tickTwoCompSep(deltaTime);
-
-				auto end = high_resolution_clock::now();
-				auto elapsed = duration_cast<nanoseconds>(end - start);
-				deltaTime = elapsed.count() / 1'000'000.0;
-				samples[i] = deltaTime;
-				acc += deltaTime;
-			}
-			fprintf(stdout, "Done! ");
-
-			// Calculate mean and std deviation values
-			mean = acc / (double)ITERATIONS_COUNT;
-			double var = 0;
-			for (size_t i = 0; i < ITERATIONS_COUNT; i++)
-			{
-				fprintf(logFile, "%.7f;", samples[i]);
-				var += (samples[i] - mean) * (samples[i] - mean);
-			}
-			fprintf(logFile, "\n");
-			var /= (double)ITERATIONS_COUNT;
-			stddev = sqrt(var);
-
-			// Cleanup
-			fprintf(stdout, "Performing clean-up... ");
-			cleanup();
-			fprintf(stdout, "Done!\n");
-
-			// Log
-			fprintf(stdout, "Finished with mean time %.7fms, and std-dev %.7fms!\n", mean, stddev);
-		}
-		fclose(logFile);
-#pragma endregion
-
-#pragma region Two Comp Simultaneously Benchmark
-		fprintf(stdout, "\nStarting Test - *Two Components Simultaneously*\n");
-		// Open Log File
-		logName = logPrefix + " - Two Components Simultaneously.csv";
-		fprintf(stdout, "Writting log to '%s'.\n", logName.c_str());
-		logFile = fopen(logName.c_str(), "w");
-		if (logFile == NULL)
-		{
-			fprintf(stderr, "Unable to create log file!\n");
-			exit(1);
-		}
-		for (int entCount : entitiesCount)
-		{
-			fprintf(stdout, "Testing with %i entities\n", entCount);
-			fprintf(logFile, "%i Entities;", entCount);
-
-			// Setup Benchmark
-			fprintf(stdout, "Allocating Entities... ");
-			setupTwoCompSim(entCount);
-			fprintf(stdout, "Done! ");
-
-			// Perform benchmark with the given iterations count
-			fprintf(stdout, "Performing tick simulations... ");
-			double acc = 0;
-			double deltaTime = 0.016;
-			for (size_t i = 0; i < ITERATIONS_COUNT; i++)
-			{
-				auto start = high_resolution_clock::now();
-
-				tickTwoCompSim(deltaTime);
-
-				auto end = high_resolution_clock::now();
-				auto elapsed = duration_cast<nanoseconds>(end - start);
-				deltaTime = elapsed.count() / 1'000'000.0;
-				samples[i] = deltaTime;
-				acc += deltaTime;
-			}
-			fprintf(stdout, "Done! ");
-
-			// Calculate mean and std deviation values
-			mean = acc / (double)ITERATIONS_COUNT;
-			double var = 0;
-			for (size_t i = 0; i < ITERATIONS_COUNT; i++)
-			{
-				fprintf(logFile, "%.7f;", samples[i]);
-				var += (samples[i] - mean) * (samples[i] - mean);
-			}
-			fprintf(logFile, "\n");
-			var /= (double)ITERATIONS_COUNT;
-			stddev = sqrt(var);
-
-			// Cleanup
-			fprintf(stdout, "Performing clean-up... ");
-			cleanup();
-			fprintf(stdout, "Done!\n");
-
-			// Log
-			fprintf(stdout, "Finished with mean time %.7fms, and std-dev %.7fms!\n", mean, stddev);
-		}
-		fclose(logFile);
-#pragma endregion
-
-#pragma region Three Comp by Pairs Benchmark
-		fprintf(stdout, "\nStarting Test - *Three Components by Pairs*\n");
-		// Open Log File
-		logName = logPrefix + " - Three Components by Pairs.csv";
-		fprintf(stdout, "Writting log to '%s'.\n", logName.c_str());
-		logFile = fopen(logName.c_str(), "w");
-		if (logFile == NULL)
-		{
-			fprintf(stderr, "Unable to create log file!\n");
-			exit(1);
-		}
-		for (int entCount : entitiesCount)
-		{
-			fprintf(stdout, "Testing with %i entities\n", entCount);
-			fprintf(logFile, "%i Entities;", entCount);
-
-			// Setup Benchmark
-			fprintf(stdout, "Allocating Entities... ");
-			setupThreeCompPair(entCount);
-			fprintf(stdout, "Done! ");
-
-			// Perform benchmark with the given iterations count
-			fprintf(stdout, "Performing tick simulations... ");
-			double acc = 0;
-			double deltaTime = 0.016;
-			for (size_t i = 0; i < ITERATIONS_COUNT; i++)
-			{
-				auto start = high_resolution_clock::now();
-
-				tickThreeCompPair(deltaTime);
-
-				auto end = high_resolution_clock::now();
-				auto elapsed = duration_cast<nanoseconds>(end - start);
-				deltaTime = elapsed.count() / 1'000'000.0;
-				samples[i] = deltaTime;
-				acc += deltaTime;
-			}
-			fprintf(stdout, "Done! ");
-
-			// Calculate mean and std deviation values
-			mean = acc / (double)ITERATIONS_COUNT;
-			double var = 0;
-			for (size_t i = 0; i < ITERATIONS_COUNT; i++)
-			{
-				fprintf(logFile, "%.7f;", samples[i]);
-				var += (samples[i] - mean) * (samples[i] - mean);
-			}
-			fprintf(logFile, "\n");
-			var /= (double)ITERATIONS_COUNT;
-			stddev = sqrt(var);
-
-			// Cleanup
-			fprintf(stdout, "Performing clean-up... ");
-			cleanup();
-			fprintf(stdout, "Done!\n");
-
-			// Log
-			fprintf(stdout, "Finished with mean time %.7fms, and std-dev %.7fms!\n", mean, stddev);
-		}
-		fclose(logFile);
-#pragma endregion
+		// Finished
+		fprintf(stdout, "\n::Benchmark for %s complete::\n", benchName.c_str());
+	}
 
-#pragma region Three Comp Simultaneously Benchmark
-		fprintf(stdout, "\nStarting Test - *Three Components Simultaneously*\n");
+private:
+	/// <summary>
+	/// Runs a single test for every entity count, logging its samples to a csv file.
+	/// </summary>
+	/// <param name="logPrefix">Prefix of the log file name.</param>
+	/// <param name="testName">Name of the test, also used as the log file suffix.</param>
+	/// <param name="setup">Setup function of the test.</param>
+	/// <param name="tick">Tick function of the test.</param>
+	inline void runTest(const string& logPrefix, const char* testName, void (IBenchmark::*setup)(int),
+		void (IBenchmark::*tick)(double))
+	{
+		fprintf(stdout, "\nStarting Test - *%s*\n", testName);
 		// Open Log File
-		logName = logPrefix + " - Three Components Simultaneously.csv";
+		string logName = logPrefix + " - " + testName + ".csv";
 		fprintf(stdout, "Writting log to '%s'.\n", logName.c_str());
 		logFile = fopen(logName.c_str(), "w");
 		if (logFile == NULL)
@@ -347,7 +125,7 @@ public:
 
 			// Setup Benchmark
 			fprintf(stdout, "Allocating Entities... ");
-			setupThreeComp(entCount);
+			(this->*setup)(entCount);
 			fprintf(stdout, "Done! ");
 
 			// Perform benchmark with the given iterations count
@@ -358,7 +136,7 @@ public:
 			{
 				auto start = high_resolution_clock::now();
 
-				tickThreeComp(deltaTime);
+				(this->*tick)(deltaTime);
 
 				auto end = high_resolution_clock::now();
 				auto elapsed = duration_cast<nanoseconds>(end - start);
@@ -389,10 +167,5 @@ public:
 			fprintf(stdout, "Finished with mean time %.7fms, and std-dev %.7fms!\n", mean, stddev);
 		}
 		fclose(logFile);
-#pragma endregion
-
-
-		// Finished
-		fprintf(stdout, "\n::Benchmark for %s complete::\n", benchName.c_str());
 	}
-};
+};
\ No newline at end of file
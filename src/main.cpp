@@ -8,7 +8,12 @@
 
 #include "ibenchmark.h"
 #include "ravineBench.hpp"
+#include "ravineEachBench.hpp"
 #include "enttBench.hpp"
+#include "queueBench.hpp"
+#include "parallelBench.hpp"
+#include "dispatchBench.hpp"
+#include "alignedBench.hpp"
 
 using namespace rv;
 using namespace entt;
@@ -18,9 +23,24 @@ int main(int argc, const char** argV)
 	RavineBench ravineBench;
 	ravineBench.run();
 
+	RavineEachBench ravineEachBench;
+	ravineEachBench.run();
+
 	EnttBench enttBench;
 	enttBench.run();
 
+	QueueBench queueBench;
+	queueBench.run();
+
+	ParallelBench parallelBench;
+	parallelBench.run();
+
+	DispatchBench dispatchBench;
+	dispatchBench.run();
+
+	AlignedBench alignedBench;
+	alignedBench.run();
+
 	fprintf(stdout, "Press any key to exit.");
 	getwchar();
 	return 0;
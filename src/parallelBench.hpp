@@ -0,0 +1,163 @@
+#pragma once
+
+#include <ravine/ecs.h>
+#include <thread>
+#include <vector>
+
+#include "ibenchmark.h"
+#include "compTypes.hpp"
+#include "systemThreeCompPair.hpp"
+
+// Amount of entities a single system runs through on each tick
+#ifndef PARALLEL_ENTITIES_COUNT
+#define PARALLEL_ENTITIES_COUNT 1'000'000
+#endif
+#ifndef PARALLEL_TICKS_COUNT
+#define PARALLEL_TICKS_COUNT 100
+#endif
+
+using std::vector;
+using namespace rv;
+
+/// <summary>
+/// Integrates positions and writes each entity speed into a flat array, indexed by the global entity offset.
+/// </summary>
+class IntegrateSystem : public BaseSystem<CompA, const CompB>
+{
+public:
+	vector<float> speeds;
+
+	inline void update(double deltaTime, int32_t offset, int32_t size, int32_t batchSize, CompA* const posArray,
+		const CompB* const velArray) final
+	{
+		// Entities created since the array was sized are not tracked
+		if ((int32_t)speeds.size() < size)
+		{
+			return;
+		}
+		for (int32_t i = 0; i < batchSize; i++)
+		{
+			CompA& pos = posArray[i];
+			const CompB& vel = velArray[i];
+			pos.x += vel.x * (float)deltaTime;
+			pos.y += vel.y * (float)deltaTime;
+			speeds[offset + i] = sqrtf(vel.x * vel.x + vel.y * vel.y);
+		}
+	}
+};
+
+/// <summary>
+/// Only touches CompC, so the SystemManager runs it alongside ThreeCompFirstSystem (CompA and CompB).
+/// </summary>
+class CompCSystem : public BaseSystem<CompC>
+{
+	inline void update(double dt, int size, CompC* const compC) final
+	{
+		for (int i = 0; i < size; i++)
+		{
+			compC[i].x += dt;
+			compC[i].y += dt;
+		}
+	}
+};
+
+/// <summary>
+/// Scaling of a single system split in parallel batches, from 1 to all hardware threads.
+/// Then independent systems ticked one after the other, and scheduled concurrently by a SystemManager.
+/// </summary>
+class ParallelBench
+{
+private:
+	/// <summary>
+	/// Ticks the system the set amount of times.
+	/// </summary>
+	/// <returns>Mean time of a tick (in ms).</returns>
+	inline double tick(IntegrateSystem& system)
+	{
+		auto start = high_resolution_clock::now();
+		for (int t = 0; t < PARALLEL_TICKS_COUNT; t++)
+		{
+			((ISystem&)system).update(1.0 / 60.0);
+		}
+		auto end = high_resolution_clock::now();
+		return duration_cast<nanoseconds>(end - start).count() / (1'000'000.0 * PARALLEL_TICKS_COUNT);
+	}
+
+	/// <summary>
+	/// Ticks two systems without conflicting accesses, serially and then through a SystemManager.
+	/// </summary>
+	inline void runScheduled()
+	{
+		fprintf(stdout, "\nTesting %i entities, %i ticks, ThreeCompFirstSystem and CompCSystem\n",
+			PARALLEL_ENTITIES_COUNT, PARALLEL_TICKS_COUNT);
+
+		Entity* entities = EntitiesManager::createEntities<CompA, CompB, CompC>(PARALLEL_ENTITIES_COUNT);
+		ThreeCompFirstSystem firstSystem;
+		CompCSystem compCSystem;
+
+		auto start = high_resolution_clock::now();
+		for (int t = 0; t < PARALLEL_TICKS_COUNT; t++)
+		{
+			((ISystem&)firstSystem).update(1.0 / 60.0);
+			((ISystem&)compCSystem).update(1.0 / 60.0);
+		}
+		auto end = high_resolution_clock::now();
+		const double serialTime = duration_cast<nanoseconds>(end - start).count() / (1'000'000.0 * PARALLEL_TICKS_COUNT);
+		fprintf(stdout, "Serial: %.3fms\n", serialTime);
+
+		// No conflicting accesses, so both systems run at the same time
+		SystemManager systemManager;
+		systemManager.addSystem(&firstSystem);
+		systemManager.addSystem(&compCSystem);
+		start = high_resolution_clock::now();
+		for (int t = 0; t < PARALLEL_TICKS_COUNT; t++)
+		{
+			systemManager.update(1.0 / 60.0);
+		}
+		end = high_resolution_clock::now();
+		const double scheduledTime = duration_cast<nanoseconds>(end - start).count() / (1'000'000.0 * PARALLEL_TICKS_COUNT);
+		fprintf(stdout, "Scheduled: %.3fms (x%.2f)\n", scheduledTime, serialTime / scheduledTime);
+
+		systemManager.clear();
+		EntitiesManager::destroyEntities(entities, PARALLEL_ENTITIES_COUNT);
+		delete[] entities;
+	}
+
+public:
+	/// <summary>
+	/// Actually runs the benchmark, doubling the threads count up to the hardware threads.
+	/// </summary>
+	inline void run()
+	{
+		fprintf(stdout, "\n\n::Starting benchmark for Parallel Systems::\n");
+		fprintf(stdout, "\nTesting %i entities, %i ticks\n", PARALLEL_ENTITIES_COUNT, PARALLEL_TICKS_COUNT);
+
+		Entity* entities = EntitiesManager::createEntities<CompA, CompB>(PARALLEL_ENTITIES_COUNT);
+		IntegrateSystem system;
+		system.speeds.resize(PARALLEL_ENTITIES_COUNT);
+
+		const double serialTime = tick(system);
+		fprintf(stdout, "Serial: %.3fms\n", serialTime);
+
+		const int hardwareThreads = max(1, (int)std::thread::hardware_concurrency());
+		for (int threadCount = 1;; threadCount = min(threadCount * 2, hardwareThreads))
+		{
+			// The calling thread runs batches too
+			ThreadPool pool(threadCount - 1);
+			system.setParallel(&pool);
+			const double parallelTime = tick(system);
+			system.setParallel(nullptr);
+			fprintf(stdout, "%i threads: %.3fms (x%.2f)\n", threadCount, parallelTime, serialTime / parallelTime);
+			if (threadCount == hardwareThreads)
+			{
+				break;
+			}
+		}
+
+		EntitiesManager::destroyEntities(entities, PARALLEL_ENTITIES_COUNT);
+		delete[] entities;
+
+		runScheduled();
+		fprintf(stdout, "\n::Benchmark for Parallel Systems complete::\n");
+	}
+};
\ No newline at end of file
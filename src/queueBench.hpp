@@ -0,0 +1,132 @@
+#pragma once
+
+#include <ravine/ecs.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ibenchmark.h"
+#include "compTypes.hpp"
+
+// Amount of structural commands pushed on each run, spread across all producers
+#ifndef COMMANDS_COUNT
+#define COMMANDS_COUNT 1'000'000
+#endif
+#ifndef PRODUCERS_COUNT
+#define PRODUCERS_COUNT { 1, 4, 16 }
+#endif
+#ifndef QUEUE_RUNS_COUNT
+#define QUEUE_RUNS_COUNT 10
+#endif
+
+using std::mutex;
+using std::thread;
+using std::vector;
+using namespace rv;
+
+static const int producersCount[] = PRODUCERS_COUNT;
+
+/// <summary>
+/// Throughput of structural commands pushed from many threads at once, each one destroying its own entities.
+/// Compares the lock-free command queue against a single command buffer protected by a mutex.
+/// </summary>
+class QueueBench
+{
+private:
+	vector<Entity> entities;
+
+	/// <summary>
+	/// Pushes the destruction of every entity from the given amount of threads, then plays them all back.
+	/// </summary>
+	/// <param name="threadCount">Amount of producer threads.</param>
+	/// <param name="push">Pushes the destruction of the given entities slice, from the given thread.</param>
+	/// <param name="drain">Plays back all the pushed commands.</param>
+	/// <param name="pushTime">Accumulated time spent pushing (in ms).</param>
+	/// <param name="drainTime">Accumulated time spent playing back (in ms).</param>
+	template <class TPush, class TDrain>
+	inline void runOnce(int threadCount, TPush push, TDrain drain, double& pushTime, double& drainTime)
+	{
+		Entity* created = EntitiesManager::createEntities<CompA>(COMMANDS_COUNT);
+		entities.assign(created, created + COMMANDS_COUNT);
+		delete[] created;
+
+		auto start = high_resolution_clock::now();
+		vector<thread> threads;
+		const int sliceSize = COMMANDS_COUNT / threadCount;
+		for (int t = 0; t < threadCount; t++)
+		{
+			const int first = t * sliceSize;
+			const int last = (t == threadCount - 1) ? COMMANDS_COUNT : first + sliceSize;
+			threads.emplace_back(push, t, first, last);
+		}
+		for (thread& producer : threads)
+		{
+			producer.join();
+		}
+		auto pushed = high_resolution_clock::now();
+		drain();
+		auto end = high_resolution_clock::now();
+
+		pushTime += duration_cast<nanoseconds>(pushed - start).count() / 1'000'000.0;
+		drainTime += duration_cast<nanoseconds>(end - pushed).count() / 1'000'000.0;
+	}
+
+	inline void log(const char* name, int threadCount, double pushTime, double drainTime)
+	{
+		pushTime /= QUEUE_RUNS_COUNT;
+		drainTime /= QUEUE_RUNS_COUNT;
+		fprintf(stdout, "%s, %i producers: push %.3fms (%.1f Mcommands/s), drain %.3fms\n", name, threadCount,
+			pushTime, COMMANDS_COUNT / (pushTime * 1000.0), drainTime);
+	}
+
+public:
+	/// <summary>
+	/// Actually runs the benchmark, for every producers count.
+	/// </summary>
+	inline void run()
+	{
+		fprintf(stdout, "\n\n::Starting benchmark for Command Queues::\n");
+		for (int threadCount : producersCount)
+		{
+			fprintf(stdout, "\nTesting %i commands with %i producers\n", COMMANDS_COUNT, threadCount);
+
+			// Lock-free queue, each thread records through its own producer
+			double pushTime = 0;
+			double drainTime = 0;
+			CommandQueue queue;
+			vector<CommandQueue::Producer*> producers;
+			for (int t = 0; t < threadCount; t++)
+			{
+				producers.push_back(queue.createProducer());
+			}
+			for (int r = 0; r < QUEUE_RUNS_COUNT; r++)
+			{
+				runOnce(threadCount, [this, &producers](int t, int first, int last) {
+					for (int i = first; i < last; i++)
+					{
+						producers[t]->destroyEntity(entities[i]);
+					}
+				}, [&queue]() { queue.drain(); }, pushTime, drainTime);
+			}
+			log("Lock-free queue", threadCount, pushTime, drainTime);
+
+			// Baseline, a single buffer shared by all threads
+			pushTime = 0;
+			drainTime = 0;
+			CommandBuffer buffer;
+			mutex bufferMutex;
+			for (int r = 0; r < QUEUE_RUNS_COUNT; r++)
+			{
+				runOnce(threadCount, [this, &buffer, &bufferMutex](int, int first, int last) {
+					for (int i = first; i < last; i++)
+					{
+						std::lock_guard<mutex> lock(bufferMutex);
+						buffer.destroyEntity(entities[i]);
+					}
+				}, [&buffer]() { buffer.playback(); }, pushTime, drainTime);
+			}
+			log("Mutex buffer", threadCount, pushTime, drainTime);
+		}
+		fprintf(stdout, "\n::Benchmark for Command Queues complete::\n");
+	}
+};
\ No newline at end of file
@@ -18,12 +18,13 @@ class RavineBench : public IBenchmark
 {
 private:
 	vector<Entity> entityStack;
-	ISystem* oneCompSystem;
-	ISystem* twoCompSepSystem;
-	ISystem* twoCompSimSystem;
-	ISystem* threeCompSystem;
-	ISystem* threeCompFirstSystem;
-	ISystem* threeCompSecondSystem;
+	ISystem* oneCompSystem = NULL;
+	ISystem* twoCompSepSystem = NULL;
+	ISystem* twoCompSimSystem = NULL;
+	ISystem* threeCompSystem = NULL;
+	ISystem* threeCompFirstSystem = NULL;
+	ISystem* threeCompSecondSystem = NULL;
+	ISystem* manyArchetypesSystem = NULL;
 
 public:
 	inline const char* getName() final
@@ -34,43 +35,46 @@ public:
 	inline void setupOneComp(int entityCount) final
 	{
 		oneCompSystem = new OneCompSystem();
-		for (int i = 0; i < entityCount; i++)
-		{
-			entityStack.push_back(EntitiesManager::createEntity<CompA>());
-		}
+		Entity* entities = EntitiesManager::createEntities<CompA>(entityCount);
+		entityStack.insert(entityStack.end(), entities, entities + entityCount);
+		delete[] entities;
 	}
 	inline void setupTwoCompSim(int entityCount) final
 	{
 		twoCompSimSystem = new TwoCompSimSystem();
-		for (int i = 0; i < entityCount; i++)
-		{
-			entityStack.push_back(EntitiesManager::createEntity<CompA, CompB>());
-		}
+		Entity* entities = EntitiesManager::createEntities<CompA, CompB>(entityCount);
+		entityStack.insert(entityStack.end(), entities, entities + entityCount);
+		delete[] entities;
 	}
 	inline void setupTwoCompSep(int entityCount) final
 	{
 		twoCompSepSystem = new TwoCompSepSystem();
-		for (int i = 0; i < entityCount; i++)
-		{
-			entityStack.push_back(EntitiesManager::createEntity<CompA, CompB>());
-		}
+		Entity* entities = EntitiesManager::createEntities<CompA, CompB>(entityCount);
+		entityStack.insert(entityStack.end(), entities, entities + entityCount);
+		delete[] entities;
 	}
 	inline void setupThreeComp(int entityCount) final
 	{
 		threeCompSystem = new ThreeCompSystem();
-		for (int i = 0; i < entityCount; i++)
-		{
-			entityStack.push_back(EntitiesManager::createEntity<CompA, CompB, CompC>());
-		}
+		Entity* entities = EntitiesManager::createEntities<CompA, CompB, CompC>(entityCount);
+		entityStack.insert(entityStack.end(), entities, entities + entityCount);
+		delete[] entities;
 	}
 	inline void setupThreeCompPair(int entityCount) final
 	{
 		threeCompFirstSystem = new ThreeCompFirstSystem();
 		threeCompSecondSystem = new ThreeCompSecondSystem();
-		for (int i = 0; i < entityCount; i++)
-		{
-			entityStack.push_back(EntitiesManager::createEntity<CompA, CompB, CompC>());
-		}
+		Entity* entities = EntitiesManager::createEntities<CompA, CompB, CompC>(entityCount);
+		entityStack.insert(entityStack.end(), entities, entities + entityCount);
+		delete[] entities;
+	}
+	inline void setupManyArchetypes(int entityCount) final
+	{
+		manyArchetypesSystem = new OneCompSystem();
+		Entity* entities = EntitiesManager::createEntities<CompA>(entityCount);
+		addTags(entities, entityCount);
+		entityStack.insert(entityStack.end(), entities, entities + entityCount);
+		delete[] entities;
 	}
 
 	inline void tickOneComp(double deltaTime) final
@@ -94,6 +98,10 @@ public:
 		threeCompFirstSystem->update(deltaTime);
 		threeCompSecondSystem->update(deltaTime);
 	}
+	inline void tickManyArchetypes(double deltaTime) final
+	{
+		manyArchetypesSystem->update(deltaTime);
+	}
 
 	inline void cleanup() final
 	{
@@ -103,14 +111,9 @@ public:
 		if (threeCompSystem != NULL) delete threeCompSystem; threeCompSystem = NULL;
 		if (threeCompFirstSystem != NULL) delete threeCompFirstSystem; threeCompFirstSystem = NULL;
 		if (threeCompSecondSystem != NULL) delete threeCompSecondSystem; threeCompSecondSystem = NULL;
+		if (manyArchetypesSystem != NULL) delete manyArchetypesSystem; manyArchetypesSystem = NULL;
 
-		size_t size = entityStack.size();
-		while (size > 0)
-		{
-			EntitiesManager::removeEntity(entityStack[size - 1]);
-			entityStack.pop_back();
-			size--;
-		}
+		EntitiesManager::destroyEntities(entityStack.data(), (int32_t)entityStack.size());
 		entityStack.clear();
 	}
 };
\ No newline at end of file
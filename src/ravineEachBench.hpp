@@ -0,0 +1,151 @@
+#pragma once
+
+#include <ravine/ecs.h>
+#include <vector>
+
+#include "ibenchmark.h"
+#include "compTypes.hpp"
+
+using std::vector;
+using namespace rv;
+
+/// <summary>
+/// Same tests as RavineBench, but ticked through ad-hoc queries (EntitiesManager::each and forEachChunk) instead
+/// of systems, mirroring the EnTT group and view loops.
+/// </summary>
+class RavineEachBench : public IBenchmark
+{
+private:
+	vector<Entity> entityStack;
+
+	template <class... TComps>
+	inline void createEntities(int entityCount)
+	{
+		Entity* entities = EntitiesManager::createEntities<TComps...>(entityCount);
+		entityStack.insert(entityStack.end(), entities, entities + entityCount);
+		delete[] entities;
+	}
+
+public:
+	inline const char* getName() final
+	{
+		return "Ravine (each)";
+	}
+
+	inline void setupOneComp(int entityCount) final
+	{
+		createEntities<CompA>(entityCount);
+	}
+	inline void setupTwoCompSim(int entityCount) final
+	{
+		createEntities<CompA, CompB>(entityCount);
+	}
+	inline void setupTwoCompSep(int entityCount) final
+	{
+		createEntities<CompA, CompB>(entityCount);
+	}
+	inline void setupThreeComp(int entityCount) final
+	{
+		createEntities<CompA, CompB, CompC>(entityCount);
+	}
+	inline void setupThreeCompPair(int entityCount) final
+	{
+		createEntities<CompA, CompB, CompC>(entityCount);
+	}
+	inline void setupManyArchetypes(int entityCount) final
+	{
+		Entity* entities = EntitiesManager::createEntities<CompA>(entityCount);
+		addTags(entities, entityCount);
+		entityStack.insert(entityStack.end(), entities, entities + entityCount);
+		delete[] entities;
+	}
+
+	inline void tickOneComp(double dt) final
+	{
+		EntitiesManager::forEachChunk<CompA>(
+			[dt](int32_t size, CompA* const compA)
+			{
+				for (int i = 0; i < size; i++)
+				{
+					compA[i].x += dt;
+					compA[i].y += dt;
+				}
+			}
+		);
+	}
+	inline void tickTwoCompSim(double dt) final
+	{
+		EntitiesManager::each<CompA, CompB>(
+			[dt](CompA& compA, CompB& compB)
+			{
+				compA.x += dt;
+				compA.y += dt;
+				compB.x += dt;
+				compB.y += dt;
+			}
+		);
+	}
+	inline void tickTwoCompSep(double dt) final
+	{
+		EntitiesManager::forEachChunk<CompA, CompB>(
+			[dt](int32_t size, CompA* const compA, CompB* const compB)
+			{
+				for (int i = 0; i < size; i++)
+				{
+					compA[i].x += dt;
+					compA[i].y += dt;
+				}
+				for (int i = 0; i < size; i++)
+				{
+					compB[i].x += dt;
+					compB[i].y += dt;
+				}
+			}
+		);
+	}
+	inline void tickThreeComp(double dt) final
+	{
+		EntitiesManager::each<CompA, CompB, CompC>(
+			[dt](CompA& compA, CompB& compB, CompC& compC)
+			{
+				compA.x += dt;
+				compA.y += dt;
+				compB.x += dt;
+				compB.y += dt;
+				compC.x += dt;
+				compC.y += dt;
+			}
+		);
+	}
+	inline void tickThreeCompPair(double dt) final
+	{
+		EntitiesManager::each<CompA, CompB>(
+			[dt](CompA& compA, CompB& compB)
+			{
+				compA.x += dt;
+				compA.y += dt;
+				compB.x += dt;
+				compB.y += dt;
+			}
+		);
+		EntitiesManager::each<CompB, CompC>(
+			[dt](CompB& compB, CompC& compC)
+			{
+				compB.x += dt;
+				compB.y += dt;
+				compC.x += dt;
+				compC.y += dt;
+			}
+		);
+	}
+	inline void tickManyArchetypes(double dt) final
+	{
+		tickOneComp(dt);
+	}
+
+	inline void cleanup() final
+	{
+		EntitiesManager::destroyEntities(entityStack.data(), (int32_t)entityStack.size());
+		entityStack.clear();
+	}
+};
\ No newline at end of file